@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+namespace signalsafe::memory {
+    //!
+    //! \brief  A bump allocator over a region of memory that's mapped (and faulted in) up front.
+    //!
+    //! \note  Creating and destroying an arena is not signal-safe and should be done up front.
+    //!        Allocating is lock-free and can be done from any thread or signal handler.
+    //!        Nothing is ever freed individually; everything allocated is released at once, by reset or a Scope.
+    //!
+    class Arena final {
+    public:
+        //!
+        //! \brief  Constructs an instance with no memory to allocate from.
+        //!
+        Arena() = default;
+        ~Arena();
+
+        // non-copyable
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // moveable
+        Arena(Arena&&);
+        Arena& operator=(Arena&&);
+
+        //!
+        //! \brief  Maps the memory for a new arena.
+        //!
+        //! \param[in]  capacity  How many bytes can be allocated; this is rounded up to a whole number of pages.
+        //!
+        //! \returns  The new arena, which has a capacity of 0 (so every allocation fails) if the memory couldn't be mapped.
+        //!
+        static Arena create(std::size_t capacity);
+
+        //!
+        //! \brief  Allocates some bytes.
+        //!
+        //! \param[in]  size       How many bytes to allocate.
+        //! \param[in]  alignment  What the address of the first byte must be a multiple of; a power of two.
+        //!
+        //! \returns  The allocated bytes, or an empty span if there isn't enough room left.
+        //!
+        std::span<std::byte> allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+        //!
+        //! \brief  Allocates and default constructs an array of objects.
+        //!
+        //! \tparam  T  The type of object. It's never destroyed, so it must be trivially destructible.
+        //!
+        //! \param[in]  count  How many objects to allocate.
+        //!
+        //! \returns  The allocated objects, or an empty span if there isn't enough room left.
+        //!
+        template <typename T>
+        std::span<T> allocate(const std::size_t count) requires std::is_trivially_destructible_v<T> {
+            // Nothing could hold that many, and the size in bytes would wrap around to something that might fit.
+            if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                return { };
+            }
+
+            const auto bytes = allocate(sizeof(T) * count, alignof(T));
+
+            if (bytes.empty()) {
+                return { };
+            }
+
+            const auto objects = reinterpret_cast<T*>(bytes.data());
+            std::uninitialized_default_construct_n(objects, count);
+            return { objects, count };
+        }
+
+        //!
+        //! \brief  Releases everything allocated so far.
+        //!
+        //! \note  Nothing allocated beforehand may be used afterwards.
+        //!
+        void reset();
+
+        //!
+        //! \brief  Gets how many bytes have been allocated, including any padding for alignment.
+        //!
+        //! \returns  The number of bytes allocated.
+        //!
+        std::size_t get_used() const;
+
+        //!
+        //! \brief  Gets how many bytes can be allocated in total.
+        //!
+        //! \returns  The number of bytes the arena holds.
+        //!
+        std::size_t get_capacity() const;
+
+        //!
+        //! \brief  Releases everything allocated during its lifetime when it's destroyed, e.g. at the end of a handler.
+        //!
+        //! \note  Scopes must be strictly nested, and nothing may be allocated from the arena by anything other than
+        //!        their owner (or a handler that interrupts it, which uses a scope of its own) while they exist.
+        //!
+        class Scope final {
+        public:
+            explicit Scope(Arena& arena);
+            ~Scope();
+
+            // non-copyable
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Arena& m_arena;
+            std::size_t m_used;
+        };
+
+    protected:
+        void create_internal(std::size_t capacity);
+
+    private:
+        static_assert(std::atomic<std::size_t>::is_always_lock_free);
+
+        std::byte* m_mapping = nullptr;
+        std::size_t m_capacity = 0;
+        std::atomic<std::size_t> m_used = 0;
+    };
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+#include <signalsafe/file.hpp>
+#include <signalsafe/memory.hpp>
+
+namespace signalsafe {
+    //!
+    //! \brief  Gathers small writes into a fixed-capacity staging buffer before passing them on to a File.
+    //!
+    //! \tparam  capacity  The size of the staging buffer, in bytes.
+    //!
+    //! \note  The staging buffer lives inside the instance, so no heap allocation ever takes place.
+    //!        The buffer is only written out when it is full, when flush() is called or on destruction.
+    //!
+    template <std::size_t capacity>
+    class BufferedFile final {
+    public:
+        static_assert(capacity > 0);
+
+        //!
+        //! \brief  Constructs an instance that refers to no file.
+        //!
+        BufferedFile() = default;
+
+        //!
+        //! \brief  Constructs an instance that buffers writes to the file provided.
+        //!
+        //! \param[in]  file  The file to write to once the buffer fills up.
+        //!
+        explicit BufferedFile(File file) : m_file(std::move(file)) { }
+
+        ~BufferedFile() {
+            flush();
+        }
+
+        // non-copyable
+        BufferedFile(const BufferedFile&) = delete;
+        BufferedFile& operator=(const BufferedFile&) = delete;
+
+        // moveable
+        BufferedFile(BufferedFile&& other) {
+            *this = std::move(other);
+        }
+
+        BufferedFile& operator=(BufferedFile&& other) {
+            flush();
+
+            m_file = std::move(other.m_file);
+
+            memory::copy_no_overlap(
+                std::span<const std::byte>(other.m_buffer.data(), other.m_bufferUsed),
+                std::span<std::byte>(m_buffer)
+            );
+
+            m_bufferUsed = other.m_bufferUsed;
+            other.m_bufferUsed = 0;
+
+            return *this;
+        }
+
+        //!
+        //! \brief  Writes the provided bytes to the staging buffer, flushing it to the file if it fills up.
+        //!
+        //! \param[in]  source  Where to read the bytes from.
+        //!
+        //! \returns  The number of bytes accepted.
+        //!
+        //! \note  Writes that are at least as big as the staging buffer bypass it entirely,
+        //!        once any previously buffered bytes have been flushed. If the file is non-blocking and
+        //!        couldn't take all of those, only what fits in the staging buffer is accepted, to keep the order.
+        //!
+        std::size_t write(std::span<const std::byte> source) {
+            if (source.size() > m_buffer.size() - m_bufferUsed) {
+                flush();
+
+                if (m_bufferUsed == 0 && source.size() >= m_buffer.size()) {
+                    return m_file.write(source);
+                }
+            }
+
+            const auto bytesAccepted = memory::copy_no_overlap(source, std::span<std::byte>(m_buffer).subspan(m_bufferUsed));
+            m_bufferUsed += bytesAccepted;
+            return bytesAccepted;
+        }
+
+        std::size_t write(std::span<const char> source) {
+            return write(std::as_bytes(source));
+        }
+
+        //!
+        //! \brief  Writes sizeof(T) bytes to the staging buffer.
+        //!
+        //! \tparam  T  The type of the source.
+        //!
+        //! \param[in]  source  Where to read the bytes from.
+        //!
+        //! \returns  The number of bytes accepted.
+        //!
+        template <typename T>
+        std::size_t write(const T& source) requires std::integral<T> {
+            return write(std::span<const std::byte, sizeof(T)>(reinterpret_cast<const std::byte*>(&source), sizeof(T)));
+        }
+
+        //!
+        //! \brief  Writes everything in the staging buffer to the file.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        //! \note  If the file is non-blocking and can't take everything right now,
+        //!        whatever wasn't written stays in the staging buffer for the next flush.
+        //!
+        std::size_t flush() {
+            if (m_bufferUsed == 0) {
+                return 0;
+            }
+
+            const auto bytesWritten = m_file.write(std::span<const std::byte>(m_buffer.data(), m_bufferUsed));
+            m_bufferUsed -= bytesWritten;
+
+            if (m_bufferUsed > 0) {
+                memory::copy_with_overlap(
+                    std::span<const std::byte>(m_buffer.data() + bytesWritten, m_bufferUsed),
+                    std::span<std::byte>(m_buffer)
+                );
+            }
+
+            return bytesWritten;
+        }
+
+        //!
+        //! \brief  Gets the number of bytes waiting to be flushed.
+        //!
+        //! \returns  The number of bytes in the staging buffer.
+        //!
+        std::size_t get_buffered_size() const {
+            return m_bufferUsed;
+        }
+
+        //!
+        //! \brief  Gets the underlying file.
+        //!
+        //! \returns  The file that the staging buffer is flushed to.
+        //!
+        //! \note  Writing to the file directly bypasses (and therefore reorders with respect to) the staging buffer.
+        //!
+        File& get_file() {
+            return m_file;
+        }
+
+    private:
+        File m_file;
+        std::array<std::byte, capacity> m_buffer;
+        std::size_t m_bufferUsed = 0;
+    };
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace signalsafe::checksum {
+    //!
+    //! \brief  Calculates the CRC-32C (Castagnoli) checksum of the bytes provided.
+    //!
+    //! \param[in]  bytes     The bytes to checksum.
+    //! \param[in]  previous  The checksum of the bytes that came before these, if continuing a checksum.
+    //!
+    //! \returns  The checksum.
+    //!
+    //! \note  This uses the SSE4.2 crc32 instruction where the CPU has it, and a lookup table otherwise.
+    //!
+    uint32_t crc32c(std::span<const std::byte> bytes, uint32_t previous = 0);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string_view>
+
+#include <signalsafe/file-handle.hpp>
+
+namespace signalsafe {
+    //!
+    //! \brief  An open directory, which files can be created, opened, renamed and removed relative to.
+    //!
+    //! \note  Working relative to an open directory means the path to it is only walked once.
+    //!        Unlike File, names don't need to be null terminated; they're copied onto the stack first.
+    //!
+    class Directory final {
+    public:
+        //!
+        //! \brief  Constructs an instance that refers to no directory.
+        //!
+        Directory() = default;
+        ~Directory();
+
+        // non-copyable
+        Directory(const Directory&) = delete;
+        Directory& operator=(const Directory&) = delete;
+
+        // moveable
+        Directory(Directory&&);
+        Directory& operator=(Directory&&);
+
+        //!
+        //! \brief  Opens an existing directory at the path provided.
+        //!
+        //! \param[in]  path  The path to the directory. It can be at most PATH_MAX bytes long, or it fails with ENAMETOOLONG.
+        //!
+        //! \returns  The opened directory, which refers to no directory if the path was too long.
+        //!
+        static Directory open_existing(std::string_view path);
+
+        //!
+        //! \brief  Creates and opens a new file in the directory.
+        //!
+        //! \param[in]  name         The name of the file, relative to the directory. It can be at most NAME_MAX bytes long, or it fails with ENAMETOOLONG.
+        //! \param[in]  permissions  The permissions to create the file with.
+        //!
+        //! \returns  The created file, opened, or a FileHandle that refers to no file if the name was too long.
+        //!
+        FileHandle create_and_open_at(std::string_view name, FileHandle::Permissions permissions) const;
+
+        //!
+        //! \brief  Creates and opens a new temporary file, with no name, in the directory.
+        //!
+        //! \returns  The created file, opened.
+        //!
+        //! \note  Use link_at to give it a name once it's complete.
+        //!
+        FileHandle create_and_open_temporary_at() const;
+
+        //!
+        //! \brief  Opens an existing file in the directory.
+        //!
+        //! \param[in]  name         The name of the file, relative to the directory. It can be at most NAME_MAX bytes long, or it fails with ENAMETOOLONG.
+        //! \param[in]  permissions  The permissions to open the file with.
+        //!
+        //! \returns  The opened file, or a FileHandle that refers to no file if the name was too long.
+        //!
+        FileHandle open_existing_at(std::string_view name, FileHandle::Permissions permissions) const;
+
+        //!
+        //! \brief  Gives an open file a name in the directory.
+        //!
+        //! \param[in]  file  The file to name, which must be on the same filesystem as the directory.
+        //! \param[in]  name  The name to give it, which mustn't already exist. It can be at most NAME_MAX bytes long, or it fails with ENAMETOOLONG.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool link_at(const FileHandle& file, std::string_view name) const;
+
+        //!
+        //! \brief  Renames a file in the directory, replacing anything that already has the new name.
+        //!
+        //! \param[in]  oldName  The file's current name. It can be at most NAME_MAX bytes long, or it fails with ENAMETOOLONG.
+        //! \param[in]  newName  The file's new name. It can be at most NAME_MAX bytes long, or it fails with ENAMETOOLONG.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool rename_at(std::string_view oldName, std::string_view newName) const;
+
+        //!
+        //! \brief  Removes (a.k.a. deletes) a file in the directory.
+        //!
+        //! \param[in]  name  The name of the file. It can be at most NAME_MAX bytes long, or it fails with ENAMETOOLONG.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool remove_at(std::string_view name) const;
+
+        //!
+        //! \brief  Closes the directory.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool close();
+
+        //!
+        //! \brief  Gets the internal file descriptor.
+        //!
+        //! \returns  The internal file descriptor, or -1 if there isn't one.
+        //!
+        FileHandle::file_descriptor_t get_file_descriptor() const;
+
+    protected:
+        void open_existing_internal(std::string_view path);
+
+    private:
+        FileHandle::file_descriptor_t m_fileDescriptor = -1;
+    };
+}
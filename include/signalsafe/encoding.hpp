@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <signalsafe/time.hpp>
+
+namespace signalsafe::encoding {
+    //!
+    //! \brief  The most bytes a 64-bit varint can take up.
+    //!
+    constexpr std::size_t maxVarintSize = 10;
+
+    //!
+    //! \brief  Maps signed integers onto unsigned ones so that small magnitudes stay small (0, -1, 1, -2 -> 0, 1, 2, 3).
+    //!
+    //! \param[in]  value  The value to map.
+    //!
+    //! \returns  The mapped value.
+    //!
+    constexpr uint64_t zigzag_encode(const int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    //!
+    //! \brief  Undoes zigzag_encode.
+    //!
+    //! \param[in]  value  The mapped value.
+    //!
+    //! \returns  The original value.
+    //!
+    constexpr int64_t zigzag_decode(const uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    //!
+    //! \brief  Writes an unsigned integer as a varint (LEB128), 7 bits per byte with the top bit set on all but the last.
+    //!
+    //! \param[out]  target  Where to write the varint.
+    //! \param[in]   value   The value to write.
+    //!
+    //! \returns  The number of bytes written, or 0 if it doesn't fit.
+    //!
+    std::size_t encode_varint(std::span<std::byte> target, uint64_t value);
+
+    //!
+    //! \brief  Writes a signed integer as a zigzag-mapped varint.
+    //!
+    //! \param[out]  target  Where to write the varint.
+    //! \param[in]   value   The value to write.
+    //!
+    //! \returns  The number of bytes written, or 0 if it doesn't fit.
+    //!
+    std::size_t encode_signed_varint(std::span<std::byte> target, int64_t value);
+
+    //!
+    //! \brief  Reads a varint (LEB128).
+    //!
+    //! \param[in]   source  Where to read the varint from.
+    //! \param[out]  value   Where to put the value read.
+    //!
+    //! \returns  The number of bytes read, or 0 if the source ends part way through (or it's too long to be valid).
+    //!
+    std::size_t decode_varint(std::span<const std::byte> source, uint64_t& value);
+
+    //!
+    //! \brief  Reads a zigzag-mapped varint.
+    //!
+    //! \param[in]   source  Where to read the varint from.
+    //! \param[out]  value   Where to put the value read.
+    //!
+    //! \returns  The number of bytes read, or 0 if the source ends part way through (or it's too long to be valid).
+    //!
+    std::size_t decode_signed_varint(std::span<const std::byte> source, int64_t& value);
+
+    //!
+    //! \brief  Reads as many consecutive varints as will fit in the target.
+    //!
+    //! \param[in]   source         Where to read the varints from.
+    //! \param[out]  target         Where to put the values read.
+    //! \param[out]  bytesConsumed  How many bytes of the source were read.
+    //!
+    //! \returns  The number of values read.
+    //!
+    //! \note  This works on 8 bytes at a time, so runs of single-byte varints are decoded without any branching per value.
+    //!
+    std::size_t decode_varints(std::span<const std::byte> source, std::span<uint64_t> target, std::size_t& bytesConsumed);
+
+    //!
+    //! \brief  Writes a stream of times, each as the change in the gap since the one before (delta of delta), as a varint.
+    //!
+    //! \note  Regularly spaced times (like samples) take a byte or two each, rather than 16.
+    //!        encode is signal-safe, but each encoder must only be used from one place at a time.
+    //!
+    class TimeEncoder final {
+    public:
+        //!
+        //! \brief  Writes the next time in the stream.
+        //!
+        //! \param[out]  target  Where to write the encoded time.
+        //! \param[in]   time    The time to write.
+        //!
+        //! \returns  The number of bytes written, or 0 if it doesn't fit (in which case the stream is unaffected).
+        //!
+        std::size_t encode(std::span<std::byte> target, const time::TimeSpecification& time);
+
+        //!
+        //! \brief  Starts a new stream, e.g. at the start of a new file.
+        //!
+        void reset();
+
+    private:
+        int64_t m_previousNanoseconds = 0;
+        int64_t m_previousDelta = 0;
+    };
+
+    //!
+    //! \brief  Reads a stream of times written by TimeEncoder.
+    //!
+    class TimeDecoder final {
+    public:
+        //!
+        //! \brief  Reads the next time in the stream.
+        //!
+        //! \param[in]   source  Where to read the encoded time from.
+        //! \param[out]  time    Where to put the time read.
+        //!
+        //! \returns  The number of bytes read, or 0 if the source ends part way through.
+        //!
+        std::size_t decode(std::span<const std::byte> source, time::TimeSpecification& time);
+
+        //!
+        //! \brief  Reads as many of the next times in the stream as will fit in the target.
+        //!
+        //! \param[in]   source         Where to read the encoded times from.
+        //! \param[out]  target         Where to put the times read.
+        //! \param[out]  bytesConsumed  How many bytes of the source were read.
+        //!
+        //! \returns  The number of times read.
+        //!
+        std::size_t decode(std::span<const std::byte> source, std::span<time::TimeSpecification> target, std::size_t& bytesConsumed);
+
+        //!
+        //! \brief  Starts a new stream, e.g. at the start of a new file.
+        //!
+        void reset();
+
+    private:
+        int64_t m_previousNanoseconds = 0;
+        int64_t m_previousDelta = 0;
+    };
+}
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+
+namespace signalsafe {
+    //!
+    //! \brief  An open file descriptor and how to treat it, without the path it was opened from.
+    //!
+    //! \note  This is just the descriptor and what to do with it on destruction, so it's cheap to move
+    //!        and to keep lots of. Use File instead if the path is needed later, e.g. to remove the file,
+    //!        and NonBlockingWriter to decide what happens when a non-blocking file can't take any more.
+    //!
+    class FileHandle final {
+    public:
+        //!
+        //! \brief  Constructs an instance that refers to no file, much like std::ifstream.
+        //!
+        FileHandle() = default;
+        ~FileHandle();
+
+        // non-copyable
+        FileHandle(const FileHandle&) = delete;
+        FileHandle& operator=(const FileHandle&) = delete;
+
+        // moveable
+        FileHandle(FileHandle&&);
+        FileHandle& operator=(FileHandle&&);
+
+        using file_descriptor_t = int;
+
+        enum class OffsetInterpretation : decltype(SEEK_SET) {
+            Absolute = SEEK_SET,
+            RelativeToCurrentPosition = SEEK_CUR,
+            RelativeToEndOfFile = SEEK_END
+        };
+
+        enum class Permissions : decltype(O_RDWR) {
+            ReadOnly = O_RDONLY,
+            WriteOnly = O_WRONLY,
+            ReadWrite = O_RDWR
+        };
+
+        enum class DestroyAction {
+            Nothing,
+            Close
+        };
+
+        //!
+        //! \brief  How far sync goes towards getting the file's contents onto the disk.
+        //!
+        enum class SyncMode {
+            Full,      //!< Wait for the data and all metadata to reach the disk (fsync).
+            Data,      //!< Wait for the data, and only the metadata needed to read it back, to reach the disk (fdatasync).
+            WriteBack  //!< Start writing back dirty data without waiting for it, or for any metadata (sync_file_range).
+        };
+
+        //!
+        //! \brief  Creates and opens a new file at the path provided.
+        //!
+        //! \param[in]  path         The path of the file to be created.
+        //! \param[in]  permissions  The permissions to create the file with.
+        //!
+        //! \returns  The created file, opened.
+        //!
+        static FileHandle create_and_open(std::string_view path, Permissions permissions);
+
+        //!
+        //! \brief  Creates and opens a new temporary file, with no name, in the directory provided.
+        //!
+        //! \param[in]  directory  The directory to create the file in (must be null terminated).
+        //!                        The filesystem it's on decides where the file's data goes.
+        //!
+        //! \returns  The created file, opened.
+        //!
+        static FileHandle create_and_open_temporary(std::string_view directory = ".");
+
+        //!
+        //! \brief  Opens an existing file at the path provided.
+        //!
+        //! \param[in]  path         The path to the file to be opened (must be null terminated).
+        //! \param[in]  permissions  The permissions to create the file with.
+        //!
+        //! \returns  The opened file.
+        //!
+        static FileHandle open_existing(std::string_view path, Permissions permissions);
+
+        //!
+        //! \brief  Creates a FileHandle instance from an existing file descriptor.
+        //!
+        //! \param[in]  fd  The file desriptor to associated the instance with.
+        //!
+        //! \returns  A file handle associated with the provided file descriptor.
+        //!
+        static FileHandle from_file_descriptor(file_descriptor_t fd);
+
+        //!
+        //! \brief  Reads the requested bytes into the target.
+        //!
+        //! \param[out]  target  Where to write the read bytes.
+        //!
+        //! \returns  The number of bytes read.
+        //!
+        std::size_t read(std::span<std::byte> target);
+        std::size_t read(std::span<char> target);
+
+        //!
+        //! \brief  Reads into each of the targets in turn, using as few syscalls as possible.
+        //!
+        //! \param[in]  targets  The buffers to write the read bytes to, in order.
+        //!
+        //! \returns  The total number of bytes read.
+        //!
+        std::size_t read(std::span<const iovec> targets);
+
+        //!
+        //! \brief  Reads sizeof(T) bytes into the target.
+        //!
+        //! \tparam  T  The type of the target.
+        //!
+        //! \param[in]  target  Where to write the read bytes.
+        //!
+        //! \returns  The number of bytes read.
+        //!
+        template <typename T>
+        std::size_t read(T& target) requires std::integral<T> {
+            return read(std::span<std::byte, sizeof(T)>(reinterpret_cast<std::byte*>(&target), sizeof(T)));
+        }
+
+        //!
+        //! \brief  Writes the provided bytes to the file.
+        //!
+        //! \param[in]  source  Where to read the bytes from.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        std::size_t write(std::span<const std::byte> source);
+        std::size_t write(std::span<const char> source);
+
+        //!
+        //! \brief  Writes each of the sources to the file in turn, using as few syscalls as possible.
+        //!
+        //! \param[in]  sources  The buffers to read the bytes from, in order.
+        //!
+        //! \returns  The total number of bytes written.
+        //!
+        std::size_t write(std::span<const iovec> sources);
+
+        //!
+        //! \brief  Writes sizeof(T) bytes to the target.
+        //!
+        //! \tparam  T  The type of the source.
+        //!
+        //! \param[in]  Where to read the bytes from.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        template <typename T>
+        std::size_t write(const T& source) requires std::integral<T> {
+            return write(std::span<const std::byte, sizeof(T)>(reinterpret_cast<const std::byte*>(&source), sizeof(T)));
+        }
+
+        //!
+        //! \brief  Reads the requested bytes into the target, starting at the offset provided.
+        //!
+        //! \param[in]   offset  Where in the file to start reading from.
+        //! \param[out]  target  Where to write the read bytes.
+        //!
+        //! \returns  The number of bytes read.
+        //!
+        //! \note  This neither uses nor changes the read/write file offset,
+        //!        so it is safe to call on the same file from multiple threads at once.
+        //!
+        std::size_t read_at(off_t offset, std::span<std::byte> target);
+        std::size_t read_at(off_t offset, std::span<char> target);
+
+        //!
+        //! \brief  Writes the provided bytes to the file, starting at the offset provided.
+        //!
+        //! \param[in]  offset  Where in the file to start writing to.
+        //! \param[in]  source  Where to read the bytes from.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        //! \note  This neither uses nor changes the read/write file offset,
+        //!        so it is safe to call on the same file from multiple threads at once.
+        //!
+        std::size_t write_at(off_t offset, std::span<const std::byte> source);
+        std::size_t write_at(off_t offset, std::span<const char> source);
+
+        //!
+        //! \brief  Copies bytes from this file to another, without them passing through user memory where possible.
+        //!
+        //! \param[in]  target  Where to copy the bytes to. They are written at its current file offset.
+        //! \param[in]  offset  Where in this file to start copying from. This file's own file offset is unaffected.
+        //! \param[in]  length  How many bytes to copy.
+        //!
+        //! \returns  The number of bytes copied, which is less than length if the end of this file is reached
+        //!           or an error occurs.
+        //!
+        //! \note  This tries copy_file_range, then sendfile, then splice, before falling back to
+        //!        reading into and writing from a small stack buffer. Each is only tried if the one before
+        //!        isn't supported for these files; the end of the file, or any other error, stops the copy.
+        //!
+        std::size_t transfer_to(FileHandle& target, off_t offset, std::size_t length);
+
+        //!
+        //! \brief  Allocates disk space for the file up front, so that writes within it don't have to.
+        //!
+        //! \param[in]  bytes  How many bytes, from the start of the file, to allocate.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        //! \note  The file is extended to be at least this long.
+        //!        If the filesystem can't allocate space up front, the file is still extended but may be sparse.
+        //!
+        bool reserve(off_t bytes);
+
+        //!
+        //! \brief  Sets the length of the file, discarding anything beyond it or padding with zeros up to it.
+        //!
+        //! \param[in]  bytes  The new length of the file.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool truncate(off_t bytes);
+
+        //!
+        //! \brief  Flushes the file's contents from the page cache towards the disk.
+        //!
+        //! \param[in]  syncMode  How far to go, and therefore how long to block for.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        //! \note  Only Full and Data make the contents durable; WriteBack just makes it cheaper to do so later.
+        //!
+        bool sync(SyncMode syncMode = SyncMode::Full);
+
+        //!
+        //! \brief  Starts writing back part of the file, without waiting for it to finish.
+        //!
+        //! \param[in]  offset  Where the part starts.
+        //! \param[in]  length  How many bytes it covers. 0 means up to the end of the file.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool start_write_back(off_t offset, off_t length);
+
+        //!
+        //! \brief  Sets whether the file is non-blocking (O_NONBLOCK).
+        //!
+        //! \param[in]  nonBlocking  True to make the file non-blocking, false to make it blocking.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        //! \note  Reads and writes on a non-blocking file return early if they can't go any further right now.
+        //!
+        bool set_non_blocking(bool nonBlocking);
+
+        //!
+        //! \brief  Closes the file.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool close();
+
+        //!
+        //! \brief  Changes the read/write file offset.
+        //!
+        //! \param[in]  offset                The offset to set the file to.
+        //! \param[in]  offsetInterpretation  How to intepret the offset.
+        //!
+        //! \returns  The new offset, or -1 if an error occured.
+        //!
+        off_t seek(off_t offset, OffsetInterpretation offsetInterpretation);
+
+        //!
+        //! \brief  Gets the internal file descriptor.
+        //!
+        //! \returns  The internal file descriptor, or -1 if there isn't one.
+        //!
+        file_descriptor_t get_file_descriptor() const;
+
+        //!
+        //! \brief  Gets the destroy action.
+        //!
+        //! \returns  The destroy action.
+        //!
+        DestroyAction get_destroy_action() const;
+
+        //!
+        //! \brief  Sets the destroy action.
+        //!
+        //! \param[in]  destroyAction  The new destroy action.
+        //!
+        void set_destroy_action(DestroyAction destroyAction);
+
+    protected:
+        void create_and_open_internal(std::string_view path, Permissions permissions);
+        void create_and_open_temporary_internal(std::string_view directory = ".");
+        void open_existing_internal(std::string_view path, Permissions permissions);
+        void from_file_descriptor_internal(file_descriptor_t fd);
+ 
+    private:
+        file_descriptor_t m_fileDescriptor = -1;
+        DestroyAction m_destroyAction = DestroyAction::Close;
+    };
+
+}
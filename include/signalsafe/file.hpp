@@ -1,22 +1,34 @@
 #pragma once
 
+#include <array>
 #include <climits>
 #include <concepts>
 #include <cstddef>
-#include <filesystem>
 #include <span>
 #include <string_view>
 
-#include <fcntl.h>
+#include <signalsafe/file-handle.hpp>
 
 namespace signalsafe {
-    class File {
+    //!
+    //! \brief  A FileHandle that also remembers the path it was opened from.
+    //!
+    //! \note  The handle is held rather than derived from, so a File can't be moved into a FileHandle
+    //!        (losing its path) by accident. It can still be passed wherever a FileHandle& is expected.
+    //!
+    class File final {
     public:
+        using file_descriptor_t = FileHandle::file_descriptor_t;
+        using OffsetInterpretation = FileHandle::OffsetInterpretation;
+        using Permissions = FileHandle::Permissions;
+        using DestroyAction = FileHandle::DestroyAction;
+        using SyncMode = FileHandle::SyncMode;
+
         //!
         //! \brief  Constructs an instance that refers to no file, much like std::ifstream.
         //!
         File() = default;
-        virtual ~File();
+        ~File() = default;
 
         // non-copyable
         File(const File&) = delete;
@@ -26,25 +38,6 @@ namespace signalsafe {
         File(File&&);
         File& operator=(File&&);
 
-        using file_descriptor_t = int;
-
-        enum class OffsetInterpretation : decltype(SEEK_SET) {
-            Absolute = SEEK_SET,
-            RelativeToCurrentPosition = SEEK_CUR,
-            RelativeToEndOfFile = SEEK_END
-        };
-
-        enum class Permissions : decltype(O_RDWR) {
-            ReadOnly = O_RDONLY,
-            WriteOnly = O_WRONLY,
-            ReadWrite = O_RDWR
-        };
-
-        enum class DestroyAction {
-            Nothing,
-            Close
-        };
-
         //!
         //! \brief  Creates and opens a new file at the path provided.
         //!
@@ -56,11 +49,15 @@ namespace signalsafe {
         static File create_and_open(std::string_view path, Permissions permissions);
 
         //!
-        //! \brief  Creates and opens a new temporary file.
+        //! \brief  Creates and opens a new temporary file, with no name, in the directory provided.
+        //!
+        //! \param[in]  directory  The directory to create the file in (must be null terminated).
         //!
         //! \returns  The created file, opened.
         //!
-        static File create_and_open_temporary();
+        //! \note  The file has no path until link_as is called.
+        //!
+        static File create_and_open_temporary(std::string_view directory = ".");
 
         //!
         //! \brief  Opens an existing file at the path provided.
@@ -82,59 +79,17 @@ namespace signalsafe {
         static File from_file_descriptor(file_descriptor_t fd);
 
         //!
-        //! \brief  Reads the requested bytes into the target.
-        //!
-        //! \param[out]  target  Where to write the read bytes.
-        //!
-        //! \returns  The number of bytes read.
-        //!
-        std::size_t read(std::span<std::byte> target);
-        std::size_t read(std::span<char> target);
-
-        //!
-        //! \brief  Reads sizeof(T) bytes into the target.
-        //!
-        //! \tparam  T  The type of the target.
-        //!
-        //! \param[in]  target  Where to write the read bytes.
-        //!
-        //! \returns  The number of bytes read.
-        //!
-        template <typename T>
-        std::size_t read(T& target) requires std::integral<T> {
-            return read(std::span<std::byte, sizeof(T)>(reinterpret_cast<std::byte*>(&target), sizeof(T)));
-        }
-
-        //!
-        //! \brief  Writes the provided bytes to the file.
-        //!
-        //! \param[in]  source  Where to read the bytes from.
-        //!
-        //! \returns  The number of bytes written.
-        //!
-        std::size_t write(std::span<const std::byte> source);
-        std::size_t write(std::span<const char> source);
-
-        //!
-        //! \brief  Writes sizeof(T) bytes to the target.
-        //!
-        //! \tparam  T  The type of the source.
+        //! \brief  Gives the file a name, so that it appears fully formed at the path provided.
         //!
-        //! \param[in]  Where to read the bytes from.
-        //!
-        //! \returns  The number of bytes written.
-        //!
-        template <typename T>
-        std::size_t write(const T& source) requires std::integral<T> {
-            return write(std::span<const std::byte, sizeof(T)>(reinterpret_cast<const std::byte*>(&source), sizeof(T)));
-        }
-
-        //!
-        //! \brief  Closes the file.
+        //! \param[in]  path  Where the file should appear (must be null terminated).
+        //!                   It must be on the same filesystem as the file and mustn't already exist.
         //!
         //! \returns  True if successful, false otherwise.
         //!
-        bool close();
+        //! \note  This is intended for temporary files, so that they can be written in full before anyone can see them.
+        //!        On success, the path provided becomes the file's path.
+        //!
+        bool link_as(std::string_view path);
 
         //!
         //! \brief  Removes (a.k.a. deletes) the file.
@@ -143,23 +98,6 @@ namespace signalsafe {
         //!
         bool remove();
 
-        //!
-        //! \brief  Changes the read/write file offset.
-        //!
-        //! \param[in]  offset                The offset to set the file to.
-        //! \param[in]  offsetInterpretation  How to intepret the offset.
-        //!
-        //! \returns  The new offset, or -1 if an error occured.
-        //!
-        off_t seek(off_t offset, OffsetInterpretation offsetInterpretation);
-
-        //!
-        //! \brief  Gets the internal file descriptor.
-        //!
-        //! \returns  The internal file descriptor, or -1 if there isn't one.
-        //!
-        file_descriptor_t get_file_descriptor() const;
-
         //!
         //! \brief  Gets the path associated with the open file.
         //!
@@ -170,29 +108,62 @@ namespace signalsafe {
         std::string_view get_path() const;
 
         //!
-        //! \brief  Gets the destroy action.
-        //!
-        //! \returns  The destroy action.
+        //! \brief  Gets the handle to the open file, for passing to anything that works on a FileHandle.
         //!
-        DestroyAction get_destroy_action() const;
-
+        //! \returns  The handle.
         //!
-        //! \brief  Sets the destroy action.
+        //! \note  Only an lvalue File converts; moving the handle out would leave the path behind.
         //!
-        //! \param[in]  destroyAction  The new destroy action.
-        //!
-        void set_destroy_action(DestroyAction destroyAction);
+        FileHandle& get_handle() { return m_handle; }
+        const FileHandle& get_handle() const { return m_handle; }
+
+        operator FileHandle&() & { return m_handle; }
+        operator const FileHandle&() const & { return m_handle; }
+        operator FileHandle&() && = delete;
+
+        // Everything else is done by the handle; see FileHandle for what each of these does.
+        std::size_t read(std::span<std::byte> target) { return m_handle.read(target); }
+        std::size_t read(std::span<char> target) { return m_handle.read(target); }
+        std::size_t read(std::span<const iovec> targets) { return m_handle.read(targets); }
+
+        template <typename T>
+        std::size_t read(T& target) requires std::integral<T> { return m_handle.read(target); }
+
+        std::size_t write(std::span<const std::byte> source) { return m_handle.write(source); }
+        std::size_t write(std::span<const char> source) { return m_handle.write(source); }
+        std::size_t write(std::span<const iovec> sources) { return m_handle.write(sources); }
+
+        template <typename T>
+        std::size_t write(const T& source) requires std::integral<T> { return m_handle.write(source); }
+
+        std::size_t read_at(off_t offset, std::span<std::byte> target) { return m_handle.read_at(offset, target); }
+        std::size_t read_at(off_t offset, std::span<char> target) { return m_handle.read_at(offset, target); }
+        std::size_t write_at(off_t offset, std::span<const std::byte> source) { return m_handle.write_at(offset, source); }
+        std::size_t write_at(off_t offset, std::span<const char> source) { return m_handle.write_at(offset, source); }
+
+        std::size_t transfer_to(FileHandle& target, off_t offset, std::size_t length) { return m_handle.transfer_to(target, offset, length); }
+
+        bool reserve(off_t bytes) { return m_handle.reserve(bytes); }
+        bool truncate(off_t bytes) { return m_handle.truncate(bytes); }
+        bool sync(SyncMode syncMode = SyncMode::Full) { return m_handle.sync(syncMode); }
+        bool start_write_back(off_t offset, off_t length) { return m_handle.start_write_back(offset, length); }
+        bool set_non_blocking(bool nonBlocking) { return m_handle.set_non_blocking(nonBlocking); }
+        bool close() { return m_handle.close(); }
+        off_t seek(off_t offset, OffsetInterpretation offsetInterpretation) { return m_handle.seek(offset, offsetInterpretation); }
+
+        file_descriptor_t get_file_descriptor() const { return m_handle.get_file_descriptor(); }
+        DestroyAction get_destroy_action() const { return m_handle.get_destroy_action(); }
+        void set_destroy_action(DestroyAction destroyAction) { m_handle.set_destroy_action(destroyAction); }
 
     protected:
         void create_and_open_internal(std::string_view path, Permissions permissions);
-        void create_and_open_temporary_internal();
+        void create_and_open_temporary_internal(std::string_view directory = ".");
         void open_existing_internal(std::string_view path, Permissions permissions);
         void from_file_descriptor_internal(file_descriptor_t fd);
- 
+
     private:
+        FileHandle m_handle;
         std::array<char, PATH_MAX + 1 /* null terminator */> m_path = { };
-        file_descriptor_t m_fileDescriptor = -1;
-        DestroyAction m_destroyAction = DestroyAction::Close;
     };
 
     File& standard_output();
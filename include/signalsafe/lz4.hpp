@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <signalsafe/file-handle.hpp>
+
+namespace signalsafe::lz4 {
+    //!
+    //! \brief  The most bytes that go into one block; this is what the frame header advertises.
+    //!
+    constexpr std::size_t maxBlockSize = 64 * 1024;
+
+    //!
+    //! \brief  Where recently seen 4-byte sequences were, for finding matches. Reusing one between blocks is fine.
+    //!
+    using HashTable = std::array<uint16_t, 4096>;
+
+    //!
+    //! \brief  Compresses one LZ4 block, with no dependency on anything compressed before it.
+    //!
+    //! \param[in]      source     The bytes to compress; at most maxBlockSize of them.
+    //! \param[out]     target     Where to write the compressed bytes.
+    //! \param[in,out]  hashTable  Scratch space for finding matches.
+    //!
+    //! \returns  The number of bytes written, or 0 if they don't fit in the target.
+    //!
+    std::size_t compress_block(std::span<const std::byte> source, std::span<std::byte> target, HashTable& hashTable);
+
+    //!
+    //! \brief  Writes the LZ4 frame header that FrameWriter uses: independent 64KiB blocks, with no checksums.
+    //!
+    //! \param[out]  target  Where to write the header.
+    //!
+    //! \returns  The number of bytes written (7), or 0 if they don't fit.
+    //!
+    std::size_t encode_frame_header(std::span<std::byte> target);
+
+    //!
+    //! \brief  Compresses what's written to it into an LZ4 frame, which the standard lz4 tool can decompress.
+    //!
+    //! \note  Everything lives inside the instance, which is therefore large (~150KiB); it's intended to be
+    //!        a global or static. No heap allocation or locking ever takes place, so write, flush and finish
+    //!        are signal-safe. Each instance must only be used from one place at a time.
+    //!
+    class FrameWriter final {
+    public:
+        //!
+        //! \brief  Constructs an instance that writes a frame to the file provided, starting with its header.
+        //!
+        //! \param[in]  file  Where to write the frame.
+        //!
+        explicit FrameWriter(FileHandle file);
+
+        ~FrameWriter();
+
+        // non-copyable
+        FrameWriter(const FrameWriter&) = delete;
+        FrameWriter& operator=(const FrameWriter&) = delete;
+
+        // non-moveable; it's far too big to want to
+        FrameWriter(FrameWriter&&) = delete;
+        FrameWriter& operator=(FrameWriter&&) = delete;
+
+        //!
+        //! \brief  Adds the bytes provided to the frame, compressing and writing out a block each time one fills up.
+        //!
+        //! \param[in]  source  The bytes to add.
+        //!
+        //! \returns  The number of bytes accepted.
+        //!
+        std::size_t write(std::span<const std::byte> source);
+        std::size_t write(std::span<const char> source);
+
+        //!
+        //! \brief  Compresses and writes out whatever has been added since the last block, even though it isn't full.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        //! \note  Lots of small blocks compress worse than a few big ones, so only flush when it matters.
+        //!
+        bool flush();
+
+        //!
+        //! \brief  Flushes, then ends the frame. Nothing more can be written afterwards.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        //! \note  This happens on destruction if it hasn't been done already.
+        //!
+        bool finish();
+
+        //!
+        //! \brief  Gets the underlying file.
+        //!
+        //! \returns  The file that the frame is written to.
+        //!
+        FileHandle& get_file();
+
+    private:
+        FileHandle m_file;
+        bool m_finished = false;
+        std::size_t m_inputUsed = 0;
+        HashTable m_hashTable = { };
+        std::array<std::byte, maxBlockSize> m_input;
+        std::array<std::byte, maxBlockSize> m_output;
+    };
+}
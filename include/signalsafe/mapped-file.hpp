@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include <signalsafe/file-handle.hpp>
+
+#include <sys/mman.h>
+
+namespace signalsafe {
+    //!
+    //! \brief  A region of a file that has been mapped into memory.
+    //!
+    //! \note  Mapping and unmapping are not signal-safe and should be done up front.
+    //!        Reading and writing the mapped bytes, as well as calling sync, can be done from a signal handler.
+    //!
+    class MappedFile final {
+    public:
+        //!
+        //! \brief  Constructs an instance that refers to no mapping.
+        //!
+        MappedFile() = default;
+        ~MappedFile();
+
+        // non-copyable
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // moveable
+        MappedFile(MappedFile&&);
+        MappedFile& operator=(MappedFile&&);
+
+        enum class SyncMode : decltype(MS_SYNC) {
+            Asynchronous = MS_ASYNC,
+            Synchronous = MS_SYNC
+        };
+
+        //!
+        //! \brief  Maps a region of the file provided into memory.
+        //!
+        //! \param[in]  file         The file to map. It must be at least offset + length bytes long, and open for
+        //!                          reading, even if the permissions are WriteOnly (pages can't be mapped write-only).
+        //! \param[in]  offset       Where in the file the region starts. It does not need to be page aligned.
+        //! \param[in]  length       The number of bytes in the region.
+        //! \param[in]  permissions  What can be done with the mapped bytes.
+        //!
+        //! \returns  The mapped region, or one with no bytes if the file can't be mapped.
+        //!
+        //! \note  Changes made to the mapped bytes are shared with the file.
+        //!        The mapping remains valid even if the file is closed.
+        //!
+        static MappedFile map(const FileHandle& file, off_t offset, std::size_t length, FileHandle::Permissions permissions);
+
+        //!
+        //! \brief  Gets the mapped bytes.
+        //!
+        //! \returns  The mapped bytes, or an empty span if nothing is mapped.
+        //!
+        std::span<std::byte> get_bytes() const;
+
+        //!
+        //! \brief  Flushes changes made to the mapped bytes back to the file.
+        //!
+        //! \param[in]  syncMode  Whether to wait for the flush to finish.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool sync(SyncMode syncMode);
+
+        //!
+        //! \brief  Unmaps the region.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool unmap();
+
+    protected:
+        void map_internal(const FileHandle& file, off_t offset, std::size_t length, FileHandle::Permissions permissions);
+
+    private:
+        // mmap works in whole pages, so the mapping may start before the bytes that were asked for.
+        std::byte* m_mapping = nullptr;
+        std::size_t m_mappingLength = 0;
+        std::span<std::byte> m_bytes;
+    };
+}
@@ -5,6 +5,15 @@
 #include <span>
 
 namespace signalsafe::memory {
+    //!
+    //! \brief  Picks the fastest copy kernels the CPU supports.
+    //!
+    //! \note  This is NOT signal-safe; call it once, before installing any signal handlers.
+    //!        Until it's called, copies use kernels that work on any CPU (SSE2 on x86-64).
+    //!        It also sets up what try_copy needs if process_vm_readv isn't available.
+    //!
+    void initialise();
+
     //!
     //! \brief  Copies memory, where the source and target do not overlap.
     //!
@@ -13,6 +22,8 @@ namespace signalsafe::memory {
     //!
     //! \returns  The number of bytes copied.
     //!
+    //! \note  Copies of up to 64 bytes are done inline, without any branching on alignment.
+    //!
     std::size_t copy_no_overlap(std::span<const std::byte> source, std::span<std::byte> target);
 
     template <typename LhsT, typename RhsT>
@@ -70,5 +81,253 @@ namespace signalsafe::memory {
             std::span<      std::byte>( reinterpret_cast<      std::byte*>(&target[0]), std::size(target) * sizeof(rhs_element_t) )
         );
     }
-}
 
+    //!
+    //! \brief  Copies of at least this many bytes made with copy_streaming bypass the cache.
+    //!
+    constexpr std::size_t streamingThreshold = 256 * 1024;
+
+    //!
+    //! \brief  Copies memory, where the source and target do not overlap, without filling the cache with the target.
+    //!
+    //! \param[in]   source  Where to read from.
+    //! \param[out]  target  Where to write to.
+    //!
+    //! \returns  The number of bytes copied.
+    //!
+    //! \note  Use this for big copies (e.g. snapshotting a whole buffer) that won't be read again soon, so that
+    //!        they don't evict everything else running. Below streamingThreshold it's the same as copy_no_overlap.
+    //!
+    std::size_t copy_streaming(std::span<const std::byte> source, std::span<std::byte> target);
+
+    template <typename LhsT, typename RhsT>
+    std::size_t copy_streaming(std::span<const LhsT> source, std::span<RhsT> target) requires (! std::is_same_v<LhsT, std::byte>)
+                                                                                           || (! std::is_same_v<RhsT, std::byte>) {
+        return copy_streaming(
+            std::as_bytes(source),
+            std::as_writable_bytes(target)
+        );
+    }
+
+    template <typename LhsT, typename RhsT>
+    std::size_t copy_streaming(const LhsT& source, RhsT& target) {
+        using lhs_element_t = decltype(source[0]);
+        using rhs_element_t = decltype(target[0]);
+
+        static_assert(std::contiguous_iterator<decltype(std::begin(source))>);
+        static_assert(std::contiguous_iterator<decltype(std::begin(target))>);
+
+        return copy_streaming(
+            std::span<const std::byte>( reinterpret_cast<const std::byte*>(&source[0]), std::size(source) * sizeof(lhs_element_t) ),
+            std::span<      std::byte>( reinterpret_cast<      std::byte*>(&target[0]), std::size(target) * sizeof(rhs_element_t) )
+        );
+    }
+
+    //!
+    //! \brief  Copies memory that may not be readable (e.g. while walking a stack through frame pointers).
+    //!
+    //! \param[in]   source  Where to read from; this may be partially or entirely unmapped or unreadable.
+    //! \param[out]  target  Where to write to; this must be writable, and not overlap the source.
+    //!
+    //! \returns  The number of bytes copied; copying stops at the first unreadable page.
+    //!
+    //! \note  No SIGSEGV is raised or needs handling; the kernel checks the source for us, with process_vm_readv
+    //!        or, failing that, by writing from it into a pipe. The latter needs initialise to have been called,
+    //!        otherwise nothing is copied, and can still fault if the source is unmapped by another thread mid-copy.
+    //!
+    std::size_t try_copy(std::span<const std::byte> source, std::span<std::byte> target);
+
+    //!
+    //! \brief  Sets every byte of some memory to the same value.
+    //!
+    //! \param[out]  target  What to fill.
+    //! \param[in]   value   What to set each byte to.
+    //!
+    //! \returns  The number of bytes set.
+    //!
+    std::size_t fill(std::span<std::byte> target, std::byte value);
+
+    template <typename T>
+    std::size_t fill(std::span<T> target, const std::byte value) requires (! std::is_same_v<T, std::byte>) {
+        return fill(std::as_writable_bytes(target), value);
+    }
+
+    template <typename T>
+    std::size_t fill(T& target, const std::byte value) {
+        static_assert(std::contiguous_iterator<decltype(std::begin(target))>);
+
+        return fill(std::span<std::byte>(std::as_writable_bytes(std::span(target))), value);
+    }
+
+    //!
+    //! \brief  Compares memory byte by byte (as unsigned values), like memcmp.
+    //!
+    //! \param[in]  lhs  The first bytes to compare.
+    //! \param[in]  rhs  The second bytes to compare.
+    //!
+    //! \returns  Less than 0 if lhs comes first, greater than 0 if rhs comes first, and 0 if they're the same.
+    //!           If one is a prefix of the other, the shorter comes first.
+    //!
+    int compare(std::span<const std::byte> lhs, std::span<const std::byte> rhs);
+
+    template <typename LhsT, typename RhsT>
+    int compare(std::span<const LhsT> lhs, std::span<const RhsT> rhs) requires (! std::is_same_v<LhsT, std::byte>)
+                                                                            || (! std::is_same_v<RhsT, std::byte>) {
+        return compare(
+            std::as_bytes(lhs),
+            std::as_bytes(rhs)
+        );
+    }
+
+    template <typename LhsT, typename RhsT>
+    int compare(const LhsT& lhs, const RhsT& rhs) {
+        static_assert(std::contiguous_iterator<decltype(std::begin(lhs))>);
+        static_assert(std::contiguous_iterator<decltype(std::begin(rhs))>);
+
+        return compare(
+            std::span<const std::byte>(std::as_bytes(std::span(lhs))),
+            std::span<const std::byte>(std::as_bytes(std::span(rhs)))
+        );
+    }
+
+    //!
+    //! \brief  Finds the first occurrence of a byte, like memchr.
+    //!
+    //! \param[in]  haystack  Where to look.
+    //! \param[in]  needle    What to look for.
+    //!
+    //! \returns  The index of the first occurrence, or the size of the haystack if there isn't one.
+    //!
+    std::size_t find(std::span<const std::byte> haystack, std::byte needle);
+
+    template <typename T>
+    std::size_t find(std::span<const T> haystack, const T needle) requires (! std::is_same_v<T, std::byte>)
+                                                                         && (sizeof(T) == 1) {
+        return find(std::as_bytes(haystack), static_cast<std::byte>(needle));
+    }
+
+    template <typename HaystackT, typename NeedleT>
+    std::size_t find(const HaystackT& haystack, const NeedleT needle) requires (sizeof(*std::data(haystack)) == 1)
+                                                                            && (sizeof(NeedleT) == 1) {
+        static_assert(std::contiguous_iterator<decltype(std::begin(haystack))>);
+
+        return find(std::span<const std::byte>(std::as_bytes(std::span(haystack))), static_cast<std::byte>(needle));
+    }
+
+    //!
+    //! \brief  Finds the first occurrence of a byte, however far away it is, like rawmemchr.
+    //!
+    //! \param[in]  haystack  Where to start looking. There must be an occurrence somewhere after this.
+    //! \param[in]  needle    What to look for.
+    //!
+    //! \returns  The number of bytes before the first occurrence.
+    //!
+    //! \note  This is how to find the length of a null terminated string.
+    //!
+    std::size_t find_unbounded(const std::byte* haystack, std::byte needle);
+
+    template <typename T>
+    std::size_t find_unbounded(const T* const haystack, const T needle) requires (! std::is_same_v<T, std::byte>)
+                                                                              && (sizeof(T) == 1) {
+        return find_unbounded(reinterpret_cast<const std::byte*>(haystack), static_cast<std::byte>(needle));
+    }
+
+    //!
+    //! \brief  Finds the first occurrence of any of a set of bytes, like strpbrk.
+    //!
+    //! \param[in]  haystack  Where to look.
+    //! \param[in]  needles   What to look for.
+    //!
+    //! \returns  The index of the first occurrence, or the size of the haystack if there isn't one.
+    //!
+    //! \note  Up to 8 needles are compared a whole chunk at a time; more than that go through a lookup table.
+    //!
+    std::size_t find_any(std::span<const std::byte> haystack, std::span<const std::byte> needles);
+
+    template <typename T>
+    std::size_t find_any(std::span<const T> haystack, std::span<const T> needles) requires (! std::is_same_v<T, std::byte>)
+                                                                                         && (sizeof(T) == 1) {
+        return find_any(std::as_bytes(haystack), std::as_bytes(needles));
+    }
+
+    template <typename HaystackT, typename NeedlesT>
+    std::size_t find_any(const HaystackT& haystack, const NeedlesT& needles) requires (sizeof(*std::data(haystack)) == 1)
+                                                                                  && (sizeof(*std::data(needles)) == 1) {
+        static_assert(std::contiguous_iterator<decltype(std::begin(haystack))>);
+        static_assert(std::contiguous_iterator<decltype(std::begin(needles))>);
+
+        return find_any(
+            std::span<const std::byte>(std::as_bytes(std::span(haystack))),
+            std::span<const std::byte>(std::as_bytes(std::span(needles)))
+        );
+    }
+
+    //!
+    //! \brief  Finds the first occurrence of a sequence of bytes, like memmem.
+    //!
+    //! \param[in]  haystack  Where to look.
+    //! \param[in]  needle    What to look for.
+    //!
+    //! \returns  The index of the first occurrence, or the size of the haystack if there isn't one.
+    //!           An empty needle is found at index 0.
+    //!
+    std::size_t find_sequence(std::span<const std::byte> haystack, std::span<const std::byte> needle);
+
+    template <typename T>
+    std::size_t find_sequence(std::span<const T> haystack, std::span<const T> needle) requires (! std::is_same_v<T, std::byte>)
+                                                                                             && (sizeof(T) == 1) {
+        return find_sequence(std::as_bytes(haystack), std::as_bytes(needle));
+    }
+
+    template <typename HaystackT, typename NeedleT>
+    std::size_t find_sequence(const HaystackT& haystack, const NeedleT& needle) requires (sizeof(*std::data(haystack)) == 1)
+                                                                                     && (sizeof(*std::data(needle)) == 1) {
+        static_assert(std::contiguous_iterator<decltype(std::begin(haystack))>);
+        static_assert(std::contiguous_iterator<decltype(std::begin(needle))>);
+
+        return find_sequence(
+            std::span<const std::byte>(std::as_bytes(std::span(haystack))),
+            std::span<const std::byte>(std::as_bytes(std::span(needle)))
+        );
+    }
+
+    namespace impl {
+        //!
+        //! \brief  The sets of kernels that bulk copies (over 64 bytes) can use.
+        //!
+        enum class CopyKernel {
+            Portable,
+            Sse2,
+            Avx2,
+            Avx512
+        };
+
+        //!
+        //! \brief  Uses the kernels specified for bulk copies from now on; mostly useful for testing them all.
+        //!
+        //! \param[in]  kernel  The kernels to use.
+        //!
+        //! \returns  True if the CPU supports them (and they'll be used), false otherwise.
+        //!
+        //! \note  As with initialise, this is NOT signal-safe.
+        //!
+        bool set_copy_kernel(CopyKernel kernel);
+
+        //!
+        //! \brief  Gets the kernels currently used for bulk copies.
+        //!
+        //! \returns  The kernels in use.
+        //!
+        CopyKernel get_copy_kernel();
+
+        //!
+        //! \brief  Does what try_copy does, but always with the pipe; mostly useful for testing it.
+        //!
+        //! \param[in]   source  Where to read from.
+        //! \param[out]  target  Where to write to.
+        //!
+        //! \returns  The number of bytes copied.
+        //!
+        std::size_t try_copy_with_pipe(std::span<const std::byte> source, std::span<std::byte> target);
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <signalsafe/file-handle.hpp>
+
+#include <sys/uio.h>
+
+namespace signalsafe {
+    //!
+    //! \brief  Writes to a non-blocking file, deciding what to do when it can't take any more bytes right now.
+    //!
+    //! \note  This is opt-in, so that a plain FileHandle stays as small as possible. The file should be made
+    //!        non-blocking (FileHandle::set_non_blocking) first; otherwise writes just block as usual.
+    //!        Writing is signal-safe, and the counters can be read from any thread.
+    //!
+    class NonBlockingWriter final {
+    public:
+        //!
+        //! \brief  What a write does when the file can't take any more bytes right now.
+        //!
+        enum class WouldBlockPolicy {
+            Wait,         //!< Keep retrying until everything is written (the same as a blocking file).
+            Drop,         //!< Write nothing if nothing has been written yet, otherwise keep retrying to finish for up to the spin limit.
+            WritePartial, //!< Stop straight away, even part way through.
+            Spin          //!< Keep retrying for up to the spin limit, then stop.
+        };
+
+        //!
+        //! \brief  Constructs an instance that refers to no file.
+        //!
+        NonBlockingWriter() = default;
+
+        //!
+        //! \brief  Constructs an instance that writes to the file provided.
+        //!
+        //! \param[in]  file                  The file to write to.
+        //! \param[in]  wouldBlockPolicy      What to do when the file can't take any more bytes right now.
+        //! \param[in]  spinLimitNanoseconds  How long to keep retrying for, if the policy is Spin
+        //!                                   (or Drop, part way through a record).
+        //!
+        NonBlockingWriter(FileHandle file, WouldBlockPolicy wouldBlockPolicy, int64_t spinLimitNanoseconds = 0);
+
+        // non-copyable
+        NonBlockingWriter(const NonBlockingWriter&) = delete;
+        NonBlockingWriter& operator=(const NonBlockingWriter&) = delete;
+
+        // non-moveable; the counters may be being read from another thread
+        NonBlockingWriter(NonBlockingWriter&&) = delete;
+        NonBlockingWriter& operator=(NonBlockingWriter&&) = delete;
+
+        //!
+        //! \brief  Writes the provided bytes to the file, as a single record.
+        //!
+        //! \param[in]  source  Where to read the bytes from.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        std::size_t write(std::span<const std::byte> source);
+        std::size_t write(std::span<const char> source);
+
+        //!
+        //! \brief  Writes each of the sources to the file in turn, as a single record.
+        //!
+        //! \param[in]  sources  The buffers to read the bytes from, in order.
+        //!
+        //! \returns  The total number of bytes written.
+        //!
+        std::size_t write(std::span<const iovec> sources);
+
+        //!
+        //! \brief  Writes sizeof(T) bytes to the file, as a single record.
+        //!
+        //! \tparam  T  The type of the source.
+        //!
+        //! \param[in]  source  Where to read the bytes from.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        template <typename T>
+        std::size_t write(const T& source) requires std::integral<T> {
+            return write(std::span<const std::byte, sizeof(T)>(reinterpret_cast<const std::byte*>(&source), sizeof(T)));
+        }
+
+        //!
+        //! \brief  Gets the would-block policy.
+        //!
+        //! \returns  The would-block policy.
+        //!
+        WouldBlockPolicy get_would_block_policy() const;
+
+        //!
+        //! \brief  Gets the number of writes that gave up before writing anything, because the file would block.
+        //!
+        //! \returns  The number of dropped writes.
+        //!
+        std::size_t get_dropped_write_count() const;
+
+        //!
+        //! \brief  Gets the number of writes that gave up part way through, because the file would block.
+        //!
+        //! \returns  The number of short writes.
+        //!
+        std::size_t get_short_write_count() const;
+
+        //!
+        //! \brief  Gets the underlying file.
+        //!
+        //! \returns  The file that's written to.
+        //!
+        FileHandle& get_file();
+
+    private:
+        std::size_t write_internal(std::span<const std::byte> source, bool recordStarted, int64_t& spinDeadline);
+        bool handle_would_block(bool recordStarted, int64_t& spinDeadline);
+
+        FileHandle m_file;
+        WouldBlockPolicy m_wouldBlockPolicy = WouldBlockPolicy::Wait;
+        int64_t m_spinLimitNanoseconds = 0;
+
+        // Bumped by writes from handlers, and read from anywhere.
+        std::atomic<std::size_t> m_droppedWriteCount = 0;
+        std::atomic<std::size_t> m_shortWriteCount = 0;
+    };
+}
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <signalsafe/file-handle.hpp>
+#include <signalsafe/memory.hpp>
+
+#include <sched.h>
+#include <sys/types.h>
+
+// An unnamed namespace won't do the trick since this is technically a header file.
+namespace signalsafe::impl {
+    enum class RseqResult {
+        Committed,
+        Aborted,
+        Changed
+    };
+
+    //!
+    //! \brief  Gets the CPU the calling thread is running on, as reported by restartable sequences (rseq).
+    //!
+    //! \returns  The CPU number, or -1 if rseq isn't available to the calling thread.
+    //!
+    //! \note  If the C library hasn't registered rseq for the thread, this tries to register it.
+    //!
+    int rseq_get_cpu();
+
+    //!
+    //! \brief  Appends to a per-CPU region as a single restartable sequence.
+    //!
+    //! \param[in]      cpu           The CPU the region belongs to.
+    //! \param[in,out]  used          How many bytes of the region are in use.
+    //! \param[in]      expectedUsed  What used must still be for the append to go ahead.
+    //! \param[out]     target        Where to copy the source to.
+    //! \param[in]      source        The bytes to append.
+    //!
+    //! \returns  Committed if used was advanced past the copied bytes,
+    //!           Aborted if the thread was preempted, migrated or signalled (or isn't on that CPU),
+    //!           and Changed if used was no longer what was expected.
+    //!
+    //! \note  This must only be called once rseq_get_cpu has returned a CPU on the calling thread.
+    //!
+    RseqResult rseq_try_append(int cpu, uint64_t& used, uint64_t expectedUsed, std::byte* target, std::span<const std::byte> source);
+
+    //!
+    //! \brief  Resets a per-CPU region as a single restartable sequence.
+    //!
+    //! \param[in]      cpu           The CPU the region belongs to.
+    //! \param[in,out]  used          How many bytes of the region are in use.
+    //! \param[in]      expectedUsed  What used must still be for the reset to go ahead.
+    //!
+    //! \returns  As rseq_try_append.
+    //!
+    //! \note  Like rseq_try_append, this must only be called once rseq_get_cpu has returned a CPU on the calling thread.
+    //!
+    RseqResult rseq_try_reset(int cpu, uint64_t& used, uint64_t expectedUsed);
+
+    //!
+    //! \brief  Saves the calling thread's CPU affinity, restoring it on destruction.
+    //!
+    class CpuAffinityGuard final {
+    public:
+        CpuAffinityGuard();
+        ~CpuAffinityGuard();
+
+        // non-copyable
+        CpuAffinityGuard(const CpuAffinityGuard&) = delete;
+        CpuAffinityGuard& operator=(const CpuAffinityGuard&) = delete;
+
+        //!
+        //! \brief  Moves the calling thread onto the CPU provided.
+        //!
+        //! \param[in]  cpu  The CPU to run on.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool pin_to(int cpu);
+
+    private:
+        cpu_set_t m_previous;
+        bool m_changed = false;
+    };
+
+    //!
+    //! \brief  Stops the calling thread from using rseq, as if the kernel didn't support it.
+    //!
+    //! \note  This can't be undone; it's for exercising the fallback, e.g. in tests.
+    //!
+    void rseq_disable();
+
+    //!
+    //! \brief  Gets the kernel's ID for the calling thread.
+    //!
+    //! \returns  The thread ID.
+    //!
+    //! \note  This is signal-safe. It's only looked up the first time it's called on each thread,
+    //!        so in a child process it can be the ID of the thread that forked.
+    //!
+    pid_t get_thread_id();
+}
+
+namespace signalsafe {
+    //!
+    //! \brief  Append-only buffers with one region per CPU, so producers on different CPUs never share cache lines.
+    //!
+    //! \tparam  capacityPerSlot  The size of each region, in bytes.
+    //! \tparam  slotCount        The number of regions; records from CPUs beyond this (or from threads beyond this
+    //!                           that are falling back at the same moment) are dropped.
+    //!
+    //! \note  Appends commit with restartable sequences (rseq) rather than atomics. If a thread can't use rseq,
+    //!        its appends fall back to a second set of regions, which are committed with a compare-and-swap.
+    //!        A thread starts looking for a free one at the region its ID hashes to, so nothing is held on to
+    //!        between appends, and any number of threads can come and go over the life of the process.
+    //!
+    //!        append is signal-safe. A handler that interrupts an append on the same thread
+    //!        either restarts it (rseq) or moves on to another region (fallback).
+    //!
+    template <std::size_t capacityPerSlot, std::size_t slotCount>
+    class PerCpuBuffer final {
+    public:
+        static_assert(capacityPerSlot > 0);
+        static_assert(slotCount > 0);
+
+        //!
+        //! \brief  Appends a record to the calling thread's current region.
+        //!
+        //! \param[in]  record  The bytes to append.
+        //!
+        //! \returns  True if the record was appended, false if it was dropped.
+        //!
+        bool append(std::span<const std::byte> record) {
+            while(true) {
+                const auto cpu = impl::rseq_get_cpu();
+
+                if (cpu < 0) {
+                    return append_to_thread_slot(record);
+                }
+
+                if (static_cast<std::size_t>(cpu) >= slotCount) {
+                    m_overflowDroppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                auto& slot = m_cpuSlots[static_cast<std::size_t>(cpu)];
+                const auto used = std::atomic_ref<uint64_t>(slot.used).load(std::memory_order_relaxed);
+
+                if (record.size() > capacityPerSlot - used) {
+                    slot.droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                // Anything other than a commit means we were interrupted or migrated, so start over.
+                if (impl::rseq_try_append(cpu, slot.used, used, slot.data.data() + used, record) == impl::RseqResult::Committed) {
+                    return true;
+                }
+            }
+        }
+
+        bool append(std::span<const char> record) {
+            return append(std::as_bytes(record));
+        }
+
+        //!
+        //! \brief  Writes every region's records to the file provided, then empties the regions.
+        //!
+        //! \param[in]  file  Where to write the records.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        //! \note  This is not signal-safe; it temporarily moves the calling thread onto each CPU in turn.
+        //!        Records from the same region are written in the order they were appended.
+        //!        Per-CPU regions can only be emptied with rseq, so if the calling thread can't use it
+        //!        they're left as they are, for a later flush from a thread that can.
+        //!
+        std::size_t flush(FileHandle& file) {
+            std::size_t bytesWritten = 0;
+
+            // This also registers rseq for the calling thread, if the C library hasn't.
+            if (impl::rseq_get_cpu() >= 0) {
+                impl::CpuAffinityGuard cpuAffinityGuard;
+
+                for (std::size_t cpu = 0; cpu < slotCount; ++cpu) {
+                    if (std::atomic_ref<uint64_t>(m_cpuSlots[cpu].used).load(std::memory_order_acquire) == 0) {
+                        continue;
+                    }
+
+                    // Only code running on the slot's CPU can safely empty it.
+                    if (cpuAffinityGuard.pin_to(static_cast<int>(cpu))) {
+                        bytesWritten += flush_cpu_slot(static_cast<int>(cpu), file);
+                    }
+                }
+            }
+
+            for (auto& slot : m_threadSlots) {
+                bytesWritten += flush_thread_slot(slot, file);
+            }
+
+            return bytesWritten;
+        }
+
+        //!
+        //! \brief  Gets the number of records that have been dropped, across every region.
+        //!
+        //! \returns  The number of dropped records.
+        //!
+        uint64_t get_dropped_count() const {
+            uint64_t droppedCount = m_overflowDroppedCount.load(std::memory_order_relaxed);
+
+            for (const auto& slot : m_cpuSlots) {
+                droppedCount += slot.droppedCount.load(std::memory_order_relaxed);
+            }
+
+            for (const auto& slot : m_threadSlots) {
+                droppedCount += slot.droppedCount.load(std::memory_order_relaxed);
+            }
+
+            return droppedCount;
+        }
+
+    private:
+        struct alignas(64) Slot {
+            uint64_t used = 0;
+            std::atomic<bool> busy = false;
+            std::atomic<uint64_t> droppedCount = 0;
+            std::array<std::byte, capacityPerSlot> data;
+        };
+
+        bool append_to_thread_slot(std::span<const std::byte> record) {
+            const auto firstIndex = static_cast<std::size_t>(impl::get_thread_id()) % slotCount;
+
+            for (std::size_t probe = 0; probe < slotCount; ++probe) {
+                auto& slot = m_threadSlots[(firstIndex + probe) % slotCount];
+
+                // Another thread (or a handler that interrupted an append on this one) is using it, so try the next.
+                if (! slot.busy.exchange(true, std::memory_order_acquire)) {
+                    return append_to_claimed_thread_slot(slot, record);
+                }
+            }
+
+            m_overflowDroppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        bool append_to_claimed_thread_slot(Slot& slot, std::span<const std::byte> record) {
+            std::atomic_ref<uint64_t> used(slot.used);
+            auto expectedUsed = used.load(std::memory_order_relaxed);
+            bool appended = false;
+
+            while(record.size() <= capacityPerSlot - expectedUsed) {
+                memory::copy_no_overlap(record, std::span<std::byte>(slot.data).subspan(expectedUsed));
+
+                // The collector may have emptied the slot while we were copying; if so, go again from the start.
+                if (used.compare_exchange_strong(expectedUsed, expectedUsed + record.size(), std::memory_order_release, std::memory_order_relaxed)) {
+                    appended = true;
+                    break;
+                }
+            }
+
+            if (! appended) {
+                slot.droppedCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            slot.busy.store(false, std::memory_order_release);
+            return appended;
+        }
+
+        std::size_t flush_cpu_slot(const int cpu, FileHandle& file) {
+            auto& slot = m_cpuSlots[static_cast<std::size_t>(cpu)];
+            std::size_t bytesWritten = 0;
+            uint64_t flushed = 0;
+
+            while(true) {
+                const auto used = std::atomic_ref<uint64_t>(slot.used).load(std::memory_order_acquire);
+                bytesWritten += file.write(std::span<const std::byte>(slot.data.data() + flushed, used - flushed));
+                flushed = used;
+
+                if (impl::rseq_try_reset(cpu, slot.used, used) == impl::RseqResult::Committed) {
+                    return bytesWritten;
+                }
+            }
+        }
+
+        std::size_t flush_thread_slot(Slot& slot, FileHandle& file) {
+            std::atomic_ref<uint64_t> used(slot.used);
+            std::size_t bytesWritten = 0;
+            uint64_t flushed = 0;
+            auto expectedUsed = used.load(std::memory_order_acquire);
+
+            while(expectedUsed != 0) {
+                bytesWritten += file.write(std::span<const std::byte>(slot.data.data() + flushed, expectedUsed - flushed));
+                flushed = expectedUsed;
+
+                if (used.compare_exchange_strong(expectedUsed, 0, std::memory_order_acquire)) {
+                    break;
+                }
+            }
+
+            return bytesWritten;
+        }
+
+        std::array<Slot, slotCount> m_cpuSlots;
+        std::array<Slot, slotCount> m_threadSlots;
+        std::atomic<uint64_t> m_overflowDroppedCount = 0;
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace signalsafe::memory {
+    //!
+    //! \brief  A fixed number of slots for objects of one type, handed out from a lock-free free list.
+    //!
+    //! \tparam  T         The type of object.
+    //! \tparam  capacity  The number of slots.
+    //!
+    //! \note  create and destroy are lock-free, and can be used from any thread or signal handler.
+    //!        The free list's head is an index paired with a tag that changes on every update,
+    //!        so a slot that's taken and returned mid-update can't be mistaken for an unchanged list (ABA).
+    //!
+    template <typename T, std::size_t capacity>
+    class Pool final {
+    public:
+        static_assert(capacity > 0);
+        static_assert(capacity < std::numeric_limits<uint32_t>::max());
+        static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+        //!
+        //! \brief  Constructs an instance with every slot free.
+        //!
+        Pool() {
+            for (std::size_t index = 0; index < capacity; ++index) {
+                m_next[index].store(static_cast<uint32_t>(index + 1), std::memory_order_relaxed);
+            }
+        }
+
+        // non-copyable
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        // non-moveable; the objects in it are referred to by address
+        Pool(Pool&&) = delete;
+        Pool& operator=(Pool&&) = delete;
+
+        //!
+        //! \brief  Takes a free slot and constructs an object in it.
+        //!
+        //! \param[in]  args  What to construct the object with.
+        //!
+        //! \returns  The new object, or nullptr if every slot is taken.
+        //!
+        template <typename... ArgsT>
+        T* create(ArgsT&&... args) {
+            auto head = m_head.load(std::memory_order_acquire);
+
+            while(true) {
+                const auto index = get_index(head);
+
+                if (index == capacity) {
+                    return nullptr;
+                }
+
+                // This may be stale if another thread takes the slot first; the exchange then fails on the tag.
+                const auto next = m_next[index].load(std::memory_order_relaxed);
+
+                if (m_head.compare_exchange_weak(head, make_head(next, get_tag(head) + 1), std::memory_order_acquire)) {
+                    return ::new (static_cast<void*>(m_slots[index].bytes)) T(std::forward<ArgsT>(args)...);
+                }
+            }
+        }
+
+        //!
+        //! \brief  Destroys an object and frees its slot.
+        //!
+        //! \param[in]  object  An object from create on this pool, or nullptr (which does nothing).
+        //!
+        void destroy(T* const object) {
+            if (object == nullptr) {
+                return;
+            }
+
+            object->~T();
+
+            const auto index = static_cast<uint32_t>(reinterpret_cast<Slot*>(object) - m_slots.data());
+            auto head = m_head.load(std::memory_order_relaxed);
+
+            do {
+                m_next[index].store(get_index(head), std::memory_order_relaxed);
+            } while(! m_head.compare_exchange_weak(head, make_head(index, get_tag(head) + 1), std::memory_order_release));
+        }
+
+        //!
+        //! \brief  Gets the number of slots.
+        //!
+        //! \returns  The number of objects the pool can hold at once.
+        //!
+        static constexpr std::size_t get_capacity() {
+            return capacity;
+        }
+
+    private:
+        struct alignas(T) Slot {
+            std::byte bytes[sizeof(T)];
+        };
+
+        static constexpr uint32_t get_index(const uint64_t head) {
+            return static_cast<uint32_t>(head);
+        }
+
+        static constexpr uint32_t get_tag(const uint64_t head) {
+            return static_cast<uint32_t>(head >> 32);
+        }
+
+        static constexpr uint64_t make_head(const uint32_t index, const uint32_t tag) {
+            return (static_cast<uint64_t>(tag) << 32) | index;
+        }
+
+        // An index of capacity means the list is empty.
+        std::atomic<uint64_t> m_head = make_head(0, 0);
+        std::array<std::atomic<uint32_t>, capacity> m_next;
+        std::array<Slot, capacity> m_slots;
+    };
+}
@@ -0,0 +1,413 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#include <signalsafe/checksum.hpp>
+#include <signalsafe/file-handle.hpp>
+#include <signalsafe/memory.hpp>
+
+#include <sys/uio.h>
+
+namespace signalsafe::record {
+    //!
+    //! \brief  What comes before every record's payload.
+    //!
+    //! \note  A type of 0 is reserved to mean "no more records", so that zeroed (e.g. reserved or mapped)
+    //!        space after the last record reads as the end rather than as garbage.
+    //!
+    struct Header final {
+        uint32_t length = 0;  //!< The size of the payload, not counting the header or any padding after it.
+        uint16_t type = 0;    //!< What the payload is.
+        uint8_t version = 0;  //!< Which version of that type's layout the payload uses.
+        uint8_t flags = 0;    //!< How the record is framed; see Flags.
+    };
+
+    static_assert(sizeof(Header) == 8);
+
+    enum Flags : uint8_t {
+        Checksummed = 1 << 0  //!< The payload is followed by a CRC-32C of the header and payload, so torn records can be spotted.
+    };
+
+    //!
+    //! \brief  The size of the checksum that follows the payload of a Checksummed record.
+    //!
+    constexpr std::size_t trailerSize = sizeof(uint32_t);
+
+    //!
+    //! \brief  The biggest payload a record can hold, since its size has to fit in Header::length.
+    //!
+    constexpr std::size_t maxPayloadSize = std::numeric_limits<decltype(Header::length)>::max();
+
+    //!
+    //! \brief  Every record starts at a multiple of this, relative to the first one.
+    //!
+    constexpr std::size_t alignment = 8;
+
+    //!
+    //! \brief  Gets how many bytes a record takes up, including its header and padding.
+    //!
+    //! \param[in]  payloadSize  The size of the payload.
+    //! \param[in]  flags        How the record is framed.
+    //!
+    //! \returns  The size of the whole record.
+    //!
+    constexpr std::size_t get_record_size(const std::size_t payloadSize, const uint8_t flags = 0) {
+        const auto unpaddedSize = payloadSize + ((flags & Checksummed) ? trailerSize : 0);
+        return sizeof(Header) + ((unpaddedSize + alignment - 1) & ~(alignment - 1));
+    }
+
+    //!
+    //! \brief  A trivially copyable type that says which record type and version it is.
+    //!
+    template <typename T>
+    concept Recordable = std::is_trivially_copyable_v<T>
+                      && alignof(T) <= alignment
+                      && requires {
+                          { T::recordType } -> std::convertible_to<uint16_t>;
+                          { T::recordVersion } -> std::convertible_to<uint8_t>;
+                      };
+
+    // An unnamed namespace won't do the trick since this is technically a header file.
+    namespace impl {
+        inline uint32_t get_checksum(const Header& header, std::span<const std::byte> payload) {
+            return checksum::crc32c(payload, checksum::crc32c(std::as_bytes(std::span<const Header, 1>(&header, 1))));
+        }
+
+        // The checksum (if there is one) followed by zeros, to go between the payload and the next record.
+        inline std::array<std::byte, trailerSize + alignment> get_trailer(const Header& header, std::span<const std::byte> payload) {
+            std::array<std::byte, trailerSize + alignment> trailer = { };
+
+            if (header.flags & Checksummed) {
+                const auto checksum = get_checksum(header, payload);
+                memory::copy_no_overlap(std::as_bytes(std::span<const uint32_t, 1>(&checksum, 1)), trailer);
+            }
+
+            return trailer;
+        }
+    }
+
+    //!
+    //! \brief  Writes a record to the file provided, in a single syscall.
+    //!
+    //! \param[in]  file     Where to write the record.
+    //! \param[in]  type     What the payload is. It mustn't be 0.
+    //! \param[in]  version  Which version of that type's layout the payload uses.
+    //! \param[in]  payload  The payload. It mustn't be bigger than maxPayloadSize.
+    //! \param[in]  flags    How to frame the record.
+    //!
+    //! \returns  The number of bytes written, which is get_record_size(payload.size(), flags) if successful,
+    //!           or 0 if the payload is too big.
+    //!
+    inline std::size_t write(FileHandle& file, const uint16_t type, const uint8_t version, std::span<const std::byte> payload, const uint8_t flags = 0) {
+        assert(type != 0);
+        assert(payload.size() <= maxPayloadSize);
+
+        // Anything bigger would have its length truncated, and be read back as a different (and broken) record.
+        if (payload.size() > maxPayloadSize) {
+            return 0;
+        }
+
+        const Header header = { static_cast<uint32_t>(payload.size()), type, version, flags };
+        const auto trailer = impl::get_trailer(header, payload);
+        const auto trailerAndPaddingSize = get_record_size(payload.size(), flags) - sizeof(Header) - payload.size();
+
+        const std::array<iovec, 3> sources = {{
+            { const_cast<Header*>(&header), sizeof(header) },
+            { const_cast<std::byte*>(payload.data()), payload.size() },
+            { const_cast<std::byte*>(trailer.data()), trailerAndPaddingSize }
+        }};
+
+        return file.write(std::span<const iovec>(sources));
+    }
+
+    //!
+    //! \brief  Writes a record holding the value provided to the file provided, in a single syscall.
+    //!
+    //! \tparam  T  The type of the payload.
+    //!
+    //! \param[in]  file     Where to write the record.
+    //! \param[in]  payload  The payload.
+    //! \param[in]  flags    How to frame the record.
+    //!
+    //! \returns  The number of bytes written.
+    //!
+    template <Recordable T>
+    std::size_t write(FileHandle& file, const T& payload, const uint8_t flags = 0) {
+        return write(file, T::recordType, T::recordVersion, std::as_bytes(std::span<const T, 1>(&payload, 1)), flags);
+    }
+
+    //!
+    //! \brief  Writes a record into the memory provided.
+    //!
+    //! \param[out]  target   Where to write the record.
+    //! \param[in]   type     What the payload is. It mustn't be 0.
+    //! \param[in]   version  Which version of that type's layout the payload uses.
+    //! \param[in]   payload  The payload. It mustn't be bigger than maxPayloadSize.
+    //! \param[in]   flags    How to frame the record.
+    //!
+    //! \returns  The number of bytes written, or 0 if the record doesn't fit or the payload is too big.
+    //!
+    inline std::size_t encode(std::span<std::byte> target, const uint16_t type, const uint8_t version, std::span<const std::byte> payload, const uint8_t flags = 0) {
+        assert(type != 0);
+        assert(payload.size() <= maxPayloadSize);
+
+        // Anything bigger would have its length truncated, and be read back as a different (and broken) record.
+        if (payload.size() > maxPayloadSize) {
+            return 0;
+        }
+
+        const auto recordSize = get_record_size(payload.size(), flags);
+
+        if (recordSize > target.size()) {
+            return 0;
+        }
+
+        const Header header = { static_cast<uint32_t>(payload.size()), type, version, flags };
+        const auto trailer = impl::get_trailer(header, payload);
+
+        memory::copy_no_overlap(std::span<const std::byte>(std::as_bytes(std::span<const Header, 1>(&header, 1))), target);
+        memory::copy_no_overlap(payload, target.subspan(sizeof(Header)));
+        memory::copy_no_overlap(std::span<const std::byte>(trailer), target.subspan(sizeof(Header) + payload.size(), recordSize - sizeof(Header) - payload.size()));
+
+        return recordSize;
+    }
+
+    //!
+    //! \brief  Writes a record holding the value provided into the memory provided.
+    //!
+    //! \tparam  T  The type of the payload.
+    //!
+    //! \param[out]  target   Where to write the record.
+    //! \param[in]   payload  The payload.
+    //! \param[in]   flags    How to frame the record.
+    //!
+    //! \returns  The number of bytes written, or 0 if the record doesn't fit.
+    //!
+    template <Recordable T>
+    std::size_t encode(std::span<std::byte> target, const T& payload, const uint8_t flags = 0) {
+        return encode(target, T::recordType, T::recordVersion, std::as_bytes(std::span<const T, 1>(&payload, 1)), flags);
+    }
+
+    //!
+    //! \brief  A record that lives in someone else's memory.
+    //!
+    class View final {
+    public:
+        View() = default;
+        View(const Header& header, std::span<const std::byte> payload) : m_header(header), m_payload(payload) { }
+
+        //!
+        //! \brief  Gets the record's header.
+        //!
+        //! \returns  The header.
+        //!
+        const Header& get_header() const {
+            return m_header;
+        }
+
+        //!
+        //! \brief  Gets the record's payload.
+        //!
+        //! \returns  The payload, not including any padding.
+        //!
+        std::span<const std::byte> get_payload() const {
+            return m_payload;
+        }
+
+        //!
+        //! \brief  Gets the payload as the type provided, without copying it.
+        //!
+        //! \tparam  T  The type to get the payload as.
+        //!
+        //! \returns  The payload, or nullptr if the record's type, version or length don't match T's.
+        //!
+        //! \note  This relies on the bytes being read from being aligned to at least record::alignment.
+        //!
+        template <Recordable T>
+        const T* get_as() const {
+            if (m_header.type != T::recordType || m_header.version != T::recordVersion || m_payload.size() != sizeof(T)) {
+                return nullptr;
+            }
+
+            return reinterpret_cast<const T*>(m_payload.data());
+        }
+
+    private:
+        Header m_header;
+        std::span<const std::byte> m_payload;
+    };
+
+    //!
+    //! \brief  Reads the record at the start of the bytes provided, checking it's complete (and intact, if checksummed).
+    //!
+    //! \param[in]   bytes  The bytes to read from.
+    //! \param[out]  view   Where to put the record, if there is one.
+    //!
+    //! \returns  True if a record was read, false otherwise.
+    //!
+    inline bool decode(std::span<const std::byte> bytes, View& view) {
+        if (bytes.size() < sizeof(Header)) {
+            return false;
+        }
+
+        Header header;
+        memory::copy_no_overlap(bytes.first(sizeof(Header)), std::as_writable_bytes(std::span<Header, 1>(&header, 1)));
+
+        if (header.type == 0 || get_record_size(header.length, header.flags) > bytes.size()) {
+            return false;
+        }
+
+        const auto payload = bytes.subspan(sizeof(Header), header.length);
+
+        if (header.flags & Checksummed) {
+            uint32_t checksum;
+            memory::copy_no_overlap(bytes.subspan(sizeof(Header) + header.length, trailerSize), std::as_writable_bytes(std::span<uint32_t, 1>(&checksum, 1)));
+
+            if (checksum != impl::get_checksum(header, payload)) {
+                return false;
+            }
+        }
+
+        view = View(header, payload);
+        return true;
+    }
+
+    //!
+    //! \brief  Finds the next intact, checksummed record, to carry on reading after a torn or corrupted one.
+    //!
+    //! \param[in]  bytes  The bytes to search, which should start just after where the last good record ended.
+    //!
+    //! \returns  How far into the bytes the next good record starts, or bytes.size() if there isn't one.
+    //!
+    //! \note  Only Checksummed records are trusted here, since anything else could just be garbage that looks like a header.
+    //!        Nor are records with flags this version doesn't know about. Candidates are checked for both (and for
+    //!        a type and length that make sense) before their checksum is, so that searching a large corrupted
+    //!        region doesn't checksum a garbage length's worth of bytes at every step.
+    //!
+    inline std::size_t find_next_valid(std::span<const std::byte> bytes) {
+        for (std::size_t offset = 0; offset + sizeof(Header) <= bytes.size(); offset += alignment) {
+            Header header;
+            memory::copy_no_overlap(bytes.subspan(offset, sizeof(Header)), std::as_writable_bytes(std::span<Header, 1>(&header, 1)));
+
+            if (header.flags != Checksummed || header.type == 0 || get_record_size(header.length, header.flags) > bytes.size() - offset) {
+                continue;
+            }
+
+            View view;
+
+            if (decode(bytes.subspan(offset), view)) {
+                return offset;
+            }
+        }
+
+        return bytes.size();
+    }
+
+    //!
+    //! \brief  Iterates over the records in some memory (e.g. a MappedFile), without copying them.
+    //!
+    //! \note  Iteration stops at the first record whose type is 0, that doesn't fit in what's left of the memory,
+    //!        or whose checksum is wrong. Use find_next_valid on the iterator's get_unread() to carry on past it.
+    //!        The memory must be aligned to at least record::alignment.
+    //!
+    class Reader final {
+    public:
+        class iterator final {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = View;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const View*;
+            using reference = const View&;
+
+            iterator() = default;
+
+            explicit iterator(std::span<const std::byte> remaining) : m_remaining(remaining) {
+                load();
+            }
+
+            reference operator*() const {
+                return m_view;
+            }
+
+            pointer operator->() const {
+                return &m_view;
+            }
+
+            iterator& operator++() {
+                m_remaining = m_remaining.subspan(get_record_size(m_view.get_header().length, m_view.get_header().flags));
+                load();
+                return *this;
+            }
+
+            iterator operator++(int) {
+                auto previous = *this;
+                ++(*this);
+                return previous;
+            }
+
+            bool operator==(const iterator& other) const {
+                return m_remaining.data() + m_remaining.size() == other.m_remaining.data() + other.m_remaining.size()
+                    && m_remaining.size() == other.m_remaining.size();
+            }
+
+            //!
+            //! \brief  Gets what's left to be iterated over, starting with the current record.
+            //!
+            //! \returns  The remaining bytes, which are empty once iteration is over.
+            //!
+            std::span<const std::byte> get_remaining() const {
+                return m_remaining;
+            }
+
+            //!
+            //! \brief  Gets everything from the current record onwards, including once iteration has stopped.
+            //!
+            //! \returns  The bytes that haven't been read yet.
+            //!
+            std::span<const std::byte> get_unread() const {
+                return m_unread;
+            }
+
+        private:
+            void load() {
+                m_unread = m_remaining;
+
+                if (! decode(m_remaining, m_view)) {
+                    m_remaining = m_remaining.last(0);
+                    m_view = { };
+                }
+            }
+
+            std::span<const std::byte> m_remaining;
+            std::span<const std::byte> m_unread;
+            View m_view;
+        };
+
+        //!
+        //! \brief  Constructs a reader over the memory provided.
+        //!
+        //! \param[in]  bytes  The records to read.
+        //!
+        explicit Reader(std::span<const std::byte> bytes) : m_bytes(bytes) { }
+
+        iterator begin() const {
+            return iterator(m_bytes);
+        }
+
+        iterator end() const {
+            return iterator(m_bytes.last(0));
+        }
+
+    private:
+        std::span<const std::byte> m_bytes;
+    };
+}
@@ -0,0 +1,435 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <signalsafe/file-handle.hpp>
+#include <signalsafe/memory.hpp>
+
+#include <sys/uio.h>
+
+// An unnamed namespace won't do the trick since this is technically a header file.
+namespace signalsafe::impl {
+    //!
+    //! \brief  The storage and record layout shared by the ring buffers.
+    //!
+    //! \note  Each record is an 8-byte header holding the payload length,
+    //!        followed by the payload padded up to a multiple of 8 bytes.
+    //!        Records always start 8-byte aligned, so a header never wraps around the end of the storage,
+    //!        but a payload may; it is then stored in two pieces.
+    //!
+    template <std::size_t capacity>
+    class RingBufferStorage {
+    public:
+        static_assert(capacity >= 16, "capacity must leave room for at least one header and payload word");
+        static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+        // Signal handlers may only use lock-free atomics.
+        static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    protected:
+        using word_t = uint64_t;
+
+        static constexpr std::size_t headerSize = sizeof(word_t);
+
+        // How many records drain gathers into a single vectored write.
+        static constexpr std::size_t drainBatchSize = 16;
+
+        static constexpr std::size_t get_record_size(const std::size_t payloadSize) {
+            return headerSize + ((payloadSize + sizeof(word_t) - 1) & ~(sizeof(word_t) - 1));
+        }
+
+        static constexpr std::size_t get_index(const uint64_t position) {
+            return static_cast<std::size_t>(position & (capacity - 1));
+        }
+
+        word_t& get_header(const uint64_t position) {
+            return m_words[get_index(position) / sizeof(word_t)];
+        }
+
+        std::span<std::byte> get_bytes() {
+            return std::as_writable_bytes(std::span<word_t>(m_words));
+        }
+
+        void copy_in(const uint64_t position, std::span<const std::byte> source) {
+            const auto bytes = get_bytes();
+            const auto index = get_index(position);
+            const std::span<std::byte> firstPiece = bytes.subspan(index);
+            const std::span<std::byte> secondPiece = bytes;
+
+            const auto bytesCopied = memory::copy_no_overlap(source, firstPiece);
+            memory::copy_no_overlap(source.subspan(bytesCopied), secondPiece);
+        }
+
+        std::size_t copy_out(const uint64_t position, const std::size_t length, std::span<std::byte> target) {
+            const auto bytes = get_bytes();
+            const auto index = get_index(position);
+            const std::span<const std::byte> firstPiece = bytes.subspan(index, std::min(length, capacity - index));
+            const std::span<const std::byte> secondPiece = bytes.first(length - firstPiece.size());
+
+            const auto bytesCopied = memory::copy_no_overlap(firstPiece, target);
+            return bytesCopied + memory::copy_no_overlap(secondPiece, target.subspan(bytesCopied));
+        }
+
+        std::size_t append_iovecs(const uint64_t position, const std::size_t length, std::span<iovec> targets) {
+            const auto bytes = get_bytes();
+            const auto index = get_index(position);
+            const auto firstPieceSize = std::min(length, capacity - index);
+
+            targets[0] = { &bytes[index], firstPieceSize };
+
+            if (firstPieceSize == length) {
+                return 1;
+            }
+
+            targets[1] = { bytes.data(), length - firstPieceSize };
+            return 2;
+        }
+
+        // Works out how far through the batch of records starting at position a drain got, given how many bytes
+        // the file took, and remembers how much of the next record is already out so that it isn't written twice.
+        uint64_t advance_past_written(uint64_t position, std::span<const std::size_t> lengths, const std::size_t bytesWritten) {
+            auto bytesRemaining = bytesWritten + m_drainedLength;
+
+            for (const auto length : lengths) {
+                if (bytesRemaining < length) {
+                    break;
+                }
+
+                bytesRemaining -= length;
+                position += get_record_size(length);
+            }
+
+            m_drainedLength = bytesRemaining;
+            return position;
+        }
+
+        void zero(const uint64_t position, const std::size_t recordSize) {
+            for (std::size_t offset = 0; offset < recordSize; offset += sizeof(word_t)) {
+                get_header(position + offset) = 0;
+            }
+        }
+
+        alignas(64) std::atomic<uint64_t> m_droppedCount = 0;
+
+        // How much of the oldest record's payload an earlier drain already wrote; only the consumer uses it.
+        alignas(64) std::size_t m_drainedLength = 0;
+
+    private:
+        std::array<word_t, capacity / sizeof(word_t)> m_words = { };
+    };
+}
+
+namespace signalsafe {
+    //!
+    //! \brief  A fixed-capacity queue of variable-length records, with one producer and one consumer.
+    //!
+    //! \tparam  capacity  The size of the storage, in bytes. Each record also uses 8 bytes for its header,
+    //!                    and is padded to a multiple of 8 bytes.
+    //!
+    //! \note  push is wait-free and signal-safe, but only one thread (or handler) may push at a time.
+    //!        If pushes can interrupt each other (e.g. a handler that may fire during another push),
+    //!        use MultiProducerRingBuffer instead.
+    //!
+    template <std::size_t capacity>
+    class SingleProducerRingBuffer final : private impl::RingBufferStorage<capacity> {
+        using storage_t = impl::RingBufferStorage<capacity>;
+
+    public:
+        //!
+        //! \brief  Adds a record to the buffer.
+        //!
+        //! \param[in]  record  The bytes that make up the record.
+        //!
+        //! \returns  True if the record was added, false if there wasn't room (in which case it is counted as dropped).
+        //!
+        //! \note  Empty records are accepted but never stored.
+        //!
+        bool push(std::span<const std::byte> record) {
+            if (record.empty()) {
+                return true;
+            }
+
+            const auto recordSize = this->get_record_size(record.size());
+            const auto writePosition = m_writePosition.load(std::memory_order_relaxed);
+            const auto readPosition = m_readPosition.load(std::memory_order_acquire);
+
+            if (writePosition + recordSize - readPosition > capacity) {
+                this->m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            this->get_header(writePosition) = record.size();
+            this->copy_in(writePosition + storage_t::headerSize, record);
+
+            m_writePosition.store(writePosition + recordSize, std::memory_order_release);
+            return true;
+        }
+
+        bool push(std::span<const char> record) {
+            return push(std::as_bytes(record));
+        }
+
+        //!
+        //! \brief  Removes the oldest record from the buffer.
+        //!
+        //! \param[out]  target  Where to write the record. If it's too small, the record is truncated.
+        //!
+        //! \returns  The number of bytes written, or 0 if the buffer was empty.
+        //!
+        //! \note  If a drain only got part way through the record, just the rest of it is popped.
+        //!
+        std::size_t pop(std::span<std::byte> target) {
+            const auto readPosition = m_readPosition.load(std::memory_order_relaxed);
+
+            if (readPosition == m_writePosition.load(std::memory_order_acquire)) {
+                return 0;
+            }
+
+            const auto length = static_cast<std::size_t>(this->get_header(readPosition));
+            const auto bytesCopied = this->copy_out(readPosition + storage_t::headerSize + this->m_drainedLength, length - this->m_drainedLength, target);
+            this->m_drainedLength = 0;
+
+            m_readPosition.store(readPosition + this->get_record_size(length), std::memory_order_release);
+            return bytesCopied;
+        }
+
+        std::size_t pop(std::span<char> target) {
+            return pop(std::as_writable_bytes(target));
+        }
+
+        //!
+        //! \brief  Removes every record from the buffer, writing them back-to-back to the file provided.
+        //!
+        //! \param[in]  file  Where to write the records.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        //! \note  If the file can't take everything right now (e.g. it's non-blocking), only what was written is removed.
+        //!        The next drain carries on from there, even if that's part way through a record.
+        //!
+        std::size_t drain(FileHandle& file) {
+            std::size_t bytesWritten = 0;
+
+            while(true) {
+                std::array<iovec, 2 * storage_t::drainBatchSize> sources;
+                std::size_t sourceCount = 0;
+
+                std::array<std::size_t, storage_t::drainBatchSize> lengths;
+                std::size_t recordCount = 0;
+                std::size_t batchSize = 0;
+
+                const auto firstReadPosition = m_readPosition.load(std::memory_order_relaxed);
+                const auto writePosition = m_writePosition.load(std::memory_order_acquire);
+                auto readPosition = firstReadPosition;
+
+                for (; recordCount < storage_t::drainBatchSize && readPosition != writePosition; ++recordCount) {
+                    const auto length = static_cast<std::size_t>(this->get_header(readPosition));
+
+                    // The start of the oldest record may have gone out in an earlier drain.
+                    const auto alreadyWritten = recordCount == 0 ? this->m_drainedLength : 0;
+                    sourceCount += this->append_iovecs(readPosition + storage_t::headerSize + alreadyWritten, length - alreadyWritten, std::span<iovec>(sources).subspan(sourceCount));
+                    batchSize += length - alreadyWritten;
+
+                    lengths[recordCount] = length;
+                    readPosition += this->get_record_size(length);
+                }
+
+                if (recordCount == 0) {
+                    return bytesWritten;
+                }
+
+                const auto batchBytesWritten = file.write(std::span<const iovec>(sources.data(), sourceCount));
+                bytesWritten += batchBytesWritten;
+                m_readPosition.store(this->advance_past_written(firstReadPosition, std::span<const std::size_t>(lengths.data(), recordCount), batchBytesWritten), std::memory_order_release);
+
+                if (batchBytesWritten != batchSize) {
+                    // The file can't take any more right now.
+                    return bytesWritten;
+                }
+            }
+        }
+
+        //!
+        //! \brief  Gets the number of records that have been dropped because the buffer was full.
+        //!
+        //! \returns  The number of dropped records.
+        //!
+        uint64_t get_dropped_count() const {
+            return this->m_droppedCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+        alignas(64) std::atomic<uint64_t> m_writePosition = 0;
+        alignas(64) std::atomic<uint64_t> m_readPosition = 0;
+    };
+
+    //!
+    //! \brief  A fixed-capacity queue of variable-length records, with any number of producers and one consumer.
+    //!
+    //! \tparam  capacity  The size of the storage, in bytes. Each record also uses 8 bytes for its header,
+    //!                    and is padded to a multiple of 8 bytes.
+    //!
+    //! \note  push is lock-free and signal-safe, and may be called from any number of threads and handlers at once.
+    //!        A producer only ever retries its reservation because another producer's succeeded.
+    //!
+    //!        Records become visible to the consumer in the order their space was reserved,
+    //!        so a producer that is interrupted mid-push holds back the records reserved after it until it resumes.
+    //!
+    template <std::size_t capacity>
+    class MultiProducerRingBuffer final : private impl::RingBufferStorage<capacity> {
+        using storage_t = impl::RingBufferStorage<capacity>;
+
+    public:
+        //!
+        //! \brief  Adds a record to the buffer.
+        //!
+        //! \param[in]  record  The bytes that make up the record.
+        //!
+        //! \returns  True if the record was added, false if there wasn't room (in which case it is counted as dropped).
+        //!
+        //! \note  Empty records are accepted but never stored.
+        //!
+        bool push(std::span<const std::byte> record) {
+            if (record.empty()) {
+                return true;
+            }
+
+            const auto recordSize = this->get_record_size(record.size());
+            auto reservePosition = m_reservePosition.load(std::memory_order_relaxed);
+
+            do {
+                if (reservePosition + recordSize - m_readPosition.load(std::memory_order_acquire) > capacity) {
+                    this->m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            } while(! m_reservePosition.compare_exchange_weak(reservePosition, reservePosition + recordSize, std::memory_order_relaxed));
+
+            this->copy_in(reservePosition + storage_t::headerSize, record);
+
+            // A non-zero header is what tells the consumer the record is complete.
+            std::atomic_ref<uint64_t>(this->get_header(reservePosition)).store(
+                (uint64_t{record.size()} << 1) | 1,
+                std::memory_order_release
+            );
+
+            return true;
+        }
+
+        bool push(std::span<const char> record) {
+            return push(std::as_bytes(record));
+        }
+
+        //!
+        //! \brief  Removes the oldest record from the buffer.
+        //!
+        //! \param[out]  target  Where to write the record. If it's too small, the record is truncated.
+        //!
+        //! \returns  The number of bytes written, or 0 if the buffer was empty.
+        //!
+        //! \note  If a drain only got part way through the record, just the rest of it is popped.
+        //!
+        std::size_t pop(std::span<std::byte> target) {
+            const auto readPosition = m_readPosition.load(std::memory_order_relaxed);
+            const auto length = get_committed_length(readPosition);
+
+            if (length == 0) {
+                return 0;
+            }
+
+            const auto bytesCopied = this->copy_out(readPosition + storage_t::headerSize + this->m_drainedLength, length - this->m_drainedLength, target);
+            this->m_drainedLength = 0;
+            release(readPosition, readPosition + this->get_record_size(length));
+            return bytesCopied;
+        }
+
+        std::size_t pop(std::span<char> target) {
+            return pop(std::as_writable_bytes(target));
+        }
+
+        //!
+        //! \brief  Removes every complete record from the buffer, writing them back-to-back to the file provided.
+        //!
+        //! \param[in]  file  Where to write the records.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        //! \note  If the file can't take everything right now (e.g. it's non-blocking), only what was written is removed.
+        //!        The next drain carries on from there, even if that's part way through a record.
+        //!
+        std::size_t drain(FileHandle& file) {
+            std::size_t bytesWritten = 0;
+
+            while(true) {
+                std::array<iovec, 2 * storage_t::drainBatchSize> sources;
+                std::size_t sourceCount = 0;
+
+                std::array<std::size_t, storage_t::drainBatchSize> lengths;
+                std::size_t recordCount = 0;
+                std::size_t batchSize = 0;
+
+                const auto firstReadPosition = m_readPosition.load(std::memory_order_relaxed);
+                auto readPosition = firstReadPosition;
+
+                for (; recordCount < storage_t::drainBatchSize; ++recordCount) {
+                    const auto length = get_committed_length(readPosition);
+
+                    if (length == 0) {
+                        break;
+                    }
+
+                    // The start of the oldest record may have gone out in an earlier drain.
+                    const auto alreadyWritten = recordCount == 0 ? this->m_drainedLength : 0;
+                    sourceCount += this->append_iovecs(readPosition + storage_t::headerSize + alreadyWritten, length - alreadyWritten, std::span<iovec>(sources).subspan(sourceCount));
+                    batchSize += length - alreadyWritten;
+
+                    lengths[recordCount] = length;
+                    readPosition += this->get_record_size(length);
+                }
+
+                if (recordCount == 0) {
+                    return bytesWritten;
+                }
+
+                const auto batchBytesWritten = file.write(std::span<const iovec>(sources.data(), sourceCount));
+                bytesWritten += batchBytesWritten;
+                release(firstReadPosition, this->advance_past_written(firstReadPosition, std::span<const std::size_t>(lengths.data(), recordCount), batchBytesWritten));
+
+                if (batchBytesWritten != batchSize) {
+                    // The file can't take any more right now.
+                    return bytesWritten;
+                }
+            }
+        }
+
+        //!
+        //! \brief  Gets the number of records that have been dropped because the buffer was full.
+        //!
+        //! \returns  The number of dropped records.
+        //!
+        uint64_t get_dropped_count() const {
+            return this->m_droppedCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::size_t get_committed_length(const uint64_t position) {
+            return static_cast<std::size_t>(
+                std::atomic_ref<uint64_t>(this->get_header(position)).load(std::memory_order_acquire) >> 1
+            );
+        }
+
+        void release(const uint64_t fromPosition, const uint64_t toPosition) {
+            // Any word may be the header of a future record, and a zero header means "not yet complete",
+            // so everything consumed has to be cleared before producers can reuse it.
+            this->zero(fromPosition, static_cast<std::size_t>(toPosition - fromPosition));
+            m_readPosition.store(toPosition, std::memory_order_release);
+        }
+
+        alignas(64) std::atomic<uint64_t> m_reservePosition = 0;
+        alignas(64) std::atomic<uint64_t> m_readPosition = 0;
+    };
+}
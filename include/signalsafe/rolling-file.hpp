@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include <signalsafe/directory.hpp>
+#include <signalsafe/file-handle.hpp>
+#include <signalsafe/memory.hpp>
+#include <signalsafe/string.hpp>
+
+namespace signalsafe {
+    //!
+    //! \brief  A set of files that is written to like one, but that moves on to a new file once the current one is full.
+    //!
+    //! \tparam  maxSegments  How many files (segments) to keep, including the one being written to.
+    //!
+    //! \note  The current segment is called name, and older ones name.1, name.2 and so on, oldest last.
+    //!        Once there are maxSegments of them, the oldest is replaced on each rotation.
+    //!
+    //!        Every name is formatted up front, so writing (and rotating) is signal-safe and never allocates.
+    //!
+    template <std::size_t maxSegments>
+    class RollingFile final {
+    public:
+        static_assert(maxSegments > 0);
+
+        //!
+        //! \brief  Constructs an instance that writes to no files.
+        //!
+        RollingFile() = default;
+
+        //!
+        //! \brief  Constructs an instance, rotating any existing segments out of the way to start a new one.
+        //!
+        //! \param[in]  directory       The directory to keep the segments in.
+        //! \param[in]  name            The name of the current segment, leaving room for a suffix within NAME_MAX bytes.
+        //! \param[in]  maxSegmentSize  How many bytes to write to a segment before moving on to the next.
+        //!
+        RollingFile(Directory directory, std::string_view name, const std::size_t maxSegmentSize)
+            : m_directory(std::move(directory)),
+              m_maxSegmentSize(maxSegmentSize) {
+            assert(maxSegmentSize > 0);
+
+            for (std::size_t segment = 0; segment < maxSegments; ++segment) {
+                auto& segmentName = m_segmentNames[segment];
+                auto bytesWritten = memory::copy_no_overlap(
+                    std::span<const char>(name.data(), name.size()),
+                    std::span<char>(segmentName)
+                );
+
+                assert(bytesWritten == name.size());
+
+                if (segment != 0) {
+                    // The null terminator that format copies over from the format string isn't counted.
+                    bytesWritten += string::format(".%", std::span<char>(segmentName).subspan(bytesWritten), uint64_t{segment}) - 1;
+                    assert(segmentName[bytesWritten] == '\0');
+                }
+
+                m_segmentNameLengths[segment] = bytesWritten;
+            }
+
+            [[maybe_unused]] const auto rotateSuccess = rotate();
+            assert(rotateSuccess);
+        }
+
+        // non-copyable
+        RollingFile(const RollingFile&) = delete;
+        RollingFile& operator=(const RollingFile&) = delete;
+
+        // moveable
+        RollingFile(RollingFile&&) = default;
+        RollingFile& operator=(RollingFile&&) = default;
+
+        //!
+        //! \brief  Writes the provided bytes to the current segment, moving on to a new one first if they wouldn't fit.
+        //!
+        //! \param[in]  source  Where to read the bytes from.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        //! \note  Writes are never split across segments, so a write bigger than the segment size gets one to itself.
+        //!
+        std::size_t write(std::span<const std::byte> source) {
+            if (m_segmentSize > 0 && source.size() > m_maxSegmentSize - std::min(m_segmentSize, m_maxSegmentSize)) {
+                if (! rotate()) {
+                    return 0;
+                }
+            }
+
+            const auto bytesWritten = m_segment.write(source);
+            m_segmentSize += bytesWritten;
+            return bytesWritten;
+        }
+
+        std::size_t write(std::span<const char> source) {
+            return write(std::as_bytes(source));
+        }
+
+        //!
+        //! \brief  Writes sizeof(T) bytes to the current segment.
+        //!
+        //! \tparam  T  The type of the source.
+        //!
+        //! \param[in]  source  Where to read the bytes from.
+        //!
+        //! \returns  The number of bytes written.
+        //!
+        template <typename T>
+        std::size_t write(const T& source) requires std::integral<T> {
+            return write(std::span<const std::byte, sizeof(T)>(reinterpret_cast<const std::byte*>(&source), sizeof(T)));
+        }
+
+        //!
+        //! \brief  Moves on to a new segment, shifting the older ones along and dropping the oldest if needs be.
+        //!
+        //! \returns  True if successful, false otherwise.
+        //!
+        bool rotate() {
+            m_segment.close();
+
+            // Segments that don't exist yet can't be renamed, which is fine.
+            for (std::size_t segment = maxSegments - 1; segment > 0; --segment) {
+                m_directory.rename_at(get_segment_name(segment - 1), get_segment_name(segment));
+            }
+
+            // With only one segment to keep, there's nothing to rename it to.
+            if constexpr (maxSegments == 1) {
+                m_directory.remove_at(get_segment_name(0));
+            }
+
+            m_segment = m_directory.create_and_open_at(get_segment_name(0), FileHandle::Permissions::WriteOnly);
+            m_segmentSize = 0;
+
+            return m_segment.get_file_descriptor() != -1;
+        }
+
+        //!
+        //! \brief  Gets the name of a segment.
+        //!
+        //! \param[in]  segment  Which segment; 0 is the current one, and higher numbers are older.
+        //!
+        //! \returns  The name of the segment, relative to the directory.
+        //!
+        std::string_view get_segment_name(const std::size_t segment) const {
+            assert(segment < maxSegments);
+            return { m_segmentNames[segment].data(), m_segmentNameLengths[segment] };
+        }
+
+        //!
+        //! \brief  Gets the number of bytes written to the current segment.
+        //!
+        //! \returns  The size of the current segment.
+        //!
+        std::size_t get_segment_size() const {
+            return m_segmentSize;
+        }
+
+    private:
+        Directory m_directory;
+        FileHandle m_segment;
+        std::size_t m_maxSegmentSize = 0;
+        std::size_t m_segmentSize = 0;
+        std::array<std::array<char, NAME_MAX + 1 /* null terminator */>, maxSegments> m_segmentNames = { };
+        std::array<std::size_t, maxSegments> m_segmentNameLengths = { };
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace signalsafe::memory {
+    //!
+    //! \brief  Gives the calling thread a scratch region of its own, for handlers that run on it to work in.
+    //!
+    //! \param[in]  size  How many bytes the region needs; this is rounded up to a whole number of pages.
+    //!
+    //! \returns  True if successful, false otherwise (including if the thread already has one).
+    //!
+    //! \note  This is NOT signal-safe; call it when the thread starts, before it can receive signals that need it.
+    //!        The region is mapped and faulted in here, so using it never allocates or takes a page fault.
+    //!
+    bool thread_attach(std::size_t size);
+
+    //!
+    //! \brief  Releases the calling thread's scratch region, if it has one.
+    //!
+    //! \note  This is NOT signal-safe; call it before the thread exits. Handlers that run afterwards see no region.
+    //!
+    void thread_detach();
+
+    //!
+    //! \brief  Gets the calling thread's scratch region.
+    //!
+    //! \returns  The region, or an empty span if thread_attach hasn't been called on this thread.
+    //!
+    //! \note  This is signal-safe, even in a library that's loaded with dlopen: the region is found through
+    //!        initial-exec TLS, which never allocates. The contents are not preserved between uses,
+    //!        and only one handler should be using it at a time (e.g. don't use it from handlers that can nest).
+    //!
+    std::span<std::byte> get_thread_scratch();
+}
@@ -2,9 +2,11 @@
 
 #include <signalsafe/string.hpp>
 
-#include <cassert>
-#include <cmath>
-#include <cstring>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 
 #include <signalsafe/memory.hpp>
 
@@ -15,53 +17,116 @@ namespace signalsafe::string::impl {
     template <typename T>
     std::size_t stringify(std::span<char> targetStr, T value) requires std::is_same_v<T, const char*>
                                                                     || std::is_same_v<T,       char*> {
-        return copy_no_overlap(std::span<const char>{ value, strlen(value) }, targetStr);
+        return copy_no_overlap(std::span<const char>{ value, memory::find_unbounded(value, '\0') }, targetStr);
     }
 
+    // Characters are text rather than numbers, and bools are neither.
     template <typename T>
-    std::size_t stringify(std::span<char> targetStr, T value) requires std::is_same_v<T, uint32_t>
-                                                                    || std::is_same_v<T, uint64_t> {
-        assert(targetStr.size() > 0);
+    concept FormattableInteger = std::is_integral_v<T>
+                              && ! std::is_same_v<T, bool>
+                              && ! std::is_same_v<T, char>
+                              && ! std::is_same_v<T, wchar_t>
+                              && ! std::is_same_v<T, char8_t>
+                              && ! std::is_same_v<T, char16_t>
+                              && ! std::is_same_v<T, char32_t>;
+
+    // "00", "01", ... "99", so that two digits can be written per division.
+    constexpr std::array<char, 200> digitPairs = []() {
+        std::array<char, 200> pairs = { };
+
+        for (std::size_t index = 0; index < 100; ++index) {
+            pairs[index * 2] = static_cast<char>('0' + index / 10);
+            pairs[index * 2 + 1] = static_cast<char>('0' + index % 10);
+        }
 
-        if (value == 0) {
-            targetStr[0] = '0';
-            return 1;
+        return pairs;
+    }();
+
+    constexpr std::array<uint64_t, 20> powersOf10 = []() {
+        std::array<uint64_t, 20> powers = { };
+        uint64_t power = 1;
+
+        for (auto& entry : powers) {
+            entry = power;
+            power *= 10;
         }
 
-        const auto digitsInValue = static_cast<std::size_t>(std::floor(std::log10(value))) + 1;
-        auto digitsLeft = digitsInValue;
+        return powers;
+    }();
+
+    //!
+    //! \brief  Counts the decimal digits in a non-zero value, using only integer operations.
+    //!
+    template <typename T>
+    constexpr std::size_t count_digits(const T value) requires std::is_unsigned_v<T> {
+        // log10(2) is about 1233 / 4096, so this is the number of digits in the smallest value with as many bits,
+        // less one; it's out by one (too low) when the value is at least the next power of 10.
+        const auto digitsLessOne = (static_cast<std::size_t>(std::bit_width(value)) * 1233) >> 12;
+        return digitsLessOne + (value >= powersOf10[digitsLessOne] ? 1 : 0);
+    }
 
-        auto currentPowerOf10 = static_cast<std::size_t>(std::floor(std::pow(10, digitsLeft - 1)));
+    //!
+    //! \brief  Writes the digits of a value backwards from the end provided, two at a time.
+    //!
+    //! \tparam  T  The type to do the arithmetic in; 32-bit divisions are much cheaper, so they're used when possible.
+    //!
+    template <typename T>
+    constexpr void write_digits(char* end, T value) requires std::is_unsigned_v<T> {
+        while(value >= 100) {
+            const auto pair = static_cast<std::size_t>(value % 100) * 2;
+            value /= 100;
+            end -= 2;
+            end[0] = digitPairs[pair];
+            end[1] = digitPairs[pair + 1];
+        }
 
-        std::size_t bytesWritten = 0;
+        if (value >= 10) {
+            const auto pair = static_cast<std::size_t>(value) * 2;
+            end -= 2;
+            end[0] = digitPairs[pair];
+            end[1] = digitPairs[pair + 1];
+        } else {
+            end -= 1;
+            end[0] = static_cast<char>('0' + value);
+        }
+    }
 
-        do {
-            const auto digitToWrite = (value / currentPowerOf10);
-            targetStr[0] = '0' + digitToWrite;
-            value -= digitToWrite * currentPowerOf10;
-            targetStr = targetStr.last(targetStr.size() - 1);
-            bytesWritten += 1;
-            digitsLeft -= 1;
-            currentPowerOf10 /= 10;
-        } while(targetStr.size() != 0 && digitsLeft != 0);
+    template <typename T>
+    std::size_t stringify(std::span<char> targetStr, const T value) requires FormattableInteger<T>
+                                                                          && std::is_unsigned_v<T> {
+        using arithmetic_t = std::conditional_t<sizeof(T) <= sizeof(uint32_t), uint32_t, uint64_t>;
 
-        return bytesWritten;
+        if (value == 0) {
+            return copy_no_overlap(std::span<const char>("0", 1), targetStr);
+        }
+
+        const auto digitsInValue = count_digits(static_cast<arithmetic_t>(value));
+
+        // Only as many of the leading digits as fit are kept.
+        std::array<char, std::numeric_limits<uint64_t>::digits10 + 1> digits;
+        write_digits(digits.data() + digitsInValue, static_cast<arithmetic_t>(value));
+
+        return copy_no_overlap(std::span<const char>(digits.data(), digitsInValue), targetStr);
     }
 
     template <typename T>
-    std::size_t stringify(std::span<char> targetStr, T value) requires std::is_same_v<T, int32_t>
-                                                                    || std::is_same_v<T, int64_t> {
-        assert(targetStr.size() > 0);
-
-        std::size_t bytesWritten = 0;
-        if (value < 0) {
-            value = value * -1;
-            targetStr[0] = '-';
-            targetStr = targetStr.last(targetStr.size() - 1);
-            bytesWritten = 1;
+    std::size_t stringify(std::span<char> targetStr, const T value) requires FormattableInteger<T>
+                                                                          && std::is_signed_v<T> {
+        using unsigned_t = std::make_unsigned_t<T>;
+
+        if (value >= 0) {
+            return stringify(targetStr, static_cast<unsigned_t>(value));
         }
 
-        return bytesWritten + stringify(targetStr, std::make_unsigned_t<T>(value));
+        if (targetStr.empty()) {
+            return 0;
+        }
+
+        targetStr[0] = '-';
+
+        // Negating in the unsigned type is fine for the most negative value, which has no positive counterpart.
+        const auto magnitude = static_cast<unsigned_t>(unsigned_t{0} - static_cast<unsigned_t>(value));
+        return 1 + stringify(targetStr.last(targetStr.size() - 1), magnitude);
     }
 }
 
@@ -82,26 +147,15 @@ namespace signalsafe::string {
 
         const size_t bytesToProcess = std::min(formatStr.size(), targetStr.size());
 
-        // The return value is either:
-        // 1) NULL, meaning the we're done.
-        // 2) A pointer to the character after the % in the targetStr buffer,
-        //    meaning some formatting needs doing.
-        const char* const formatCharacterTarget = static_cast<char*>(
-            memccpy(
-                targetStr.data(),
-                formatStr.data(),
-                '%',
-                bytesToProcess
-            )
-        );
-
-        if (formatCharacterTarget == nullptr) {
+        // Everything before the first % (if there is one) is copied as is.
+        const auto formatCharacterIndex = memory::find(formatStr.first(bytesToProcess), '%');
+        copy_no_overlap(formatStr.first(formatCharacterIndex), targetStr);
+
+        if (formatCharacterIndex == bytesToProcess) {
             return bytesToProcess;
         }
 
-        assert(*(formatCharacterTarget - 1) == '%');
-
-        auto bytesWritten = static_cast<std::size_t>(formatCharacterTarget - targetStr.data()) - 1 /* for the % */;
+        auto bytesWritten = formatCharacterIndex;
         formatStr = formatStr.last(formatStr.size() - (bytesWritten + 1));
         targetStr = targetStr.last(targetStr.size() - bytesWritten);
 
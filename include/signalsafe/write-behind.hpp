@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cassert>
+
+#include <signalsafe/file-handle.hpp>
+
+#include <sys/types.h>
+
+namespace signalsafe {
+    //!
+    //! \brief  Starts write-back of a file in fixed-size chunks as they are completed, without ever waiting for it.
+    //!
+    //! \note  This keeps the amount of dirty page cache a sequential writer leaves behind it small,
+    //!        so that a later sync (or the kernel's own flusher) doesn't stall on a large backlog.
+    //!
+    //!        The file must outlive this instance.
+    //!
+    class WriteBehind final {
+    public:
+        //!
+        //! \brief  Constructs an instance that starts write-back of the file provided.
+        //!
+        //! \param[in]  file       The file being written to.
+        //! \param[in]  chunkSize  How many bytes to start writing back at a time; write-back only starts for whole chunks.
+        //! \param[in]  offset     Where in the file write-back should start from.
+        //!
+        WriteBehind(FileHandle& file, off_t chunkSize, off_t offset = 0)
+            : m_file(&file),
+              m_chunkSize(chunkSize),
+              m_writtenBackUpTo(offset) {
+            assert(chunkSize > 0);
+        }
+
+        //!
+        //! \brief  Tells the instance how far the file has been written, starting write-back of any chunks now complete.
+        //!
+        //! \param[in]  writtenUpTo  The offset everything before which has been written.
+        //!
+        //! \returns  True if write-back was started or there was nothing to start, false otherwise.
+        //!
+        bool advance(const off_t writtenUpTo) {
+            const auto chunkCount = (writtenUpTo - m_writtenBackUpTo) / m_chunkSize;
+
+            if (chunkCount <= 0) {
+                return true;
+            }
+
+            const auto length = chunkCount * m_chunkSize;
+
+            if (! m_file->start_write_back(m_writtenBackUpTo, length)) {
+                return false;
+            }
+
+            m_writtenBackUpTo += length;
+            return true;
+        }
+
+        //!
+        //! \brief  Gets how far write-back has been started.
+        //!
+        //! \returns  The offset everything before which has had write-back started.
+        //!
+        off_t get_written_back_up_to() const {
+            return m_writtenBackUpTo;
+        }
+
+    private:
+        FileHandle* m_file = nullptr;
+        off_t m_chunkSize = 0;
+        off_t m_writtenBackUpTo = 0;
+    };
+}
@@ -0,0 +1,115 @@
+#include "signalsafe/arena.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using signalsafe::memory::Arena;
+
+Arena::~Arena() {
+    if (m_mapping != nullptr) {
+        [[maybe_unused]] const auto unmapResult = ::munmap(m_mapping, m_capacity);
+        assert(unmapResult == 0);
+    }
+}
+
+Arena::Arena(Arena&& other) {
+    *this = std::move(other);
+}
+
+Arena& Arena::operator=(Arena&& other) {
+    if (m_mapping != nullptr) {
+        [[maybe_unused]] const auto unmapResult = ::munmap(m_mapping, m_capacity);
+        assert(unmapResult == 0);
+    }
+
+    this->m_mapping = other.m_mapping;
+    other.m_mapping = nullptr;
+
+    this->m_capacity = other.m_capacity;
+    other.m_capacity = 0;
+
+    this->m_used.store(other.m_used.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    other.m_used.store(0, std::memory_order_relaxed);
+
+    return *this;
+}
+
+Arena Arena::create(const std::size_t capacity) {
+    Arena arena;
+    arena.create_internal(capacity);
+    return arena;
+}
+
+void Arena::create_internal(const std::size_t capacity) {
+    assert(capacity > 0);
+
+    const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+    // Rounding this up would wrap around, and there could never be that much to map anyway.
+    if (capacity > std::numeric_limits<std::size_t>::max() - (pageSize - 1)) {
+        return;
+    }
+
+    const auto mappingLength = (capacity + pageSize - 1) / pageSize * pageSize;
+
+    // Populating up front means handlers never take a page fault (and the kernel never has to find a page) mid-allocation.
+    void* const mapping = ::mmap(
+        nullptr,
+        mappingLength,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
+        -1,
+        0
+    );
+
+    // Left empty, every allocation fails cleanly rather than handing out memory that isn't there.
+    if (mapping == MAP_FAILED) {
+        return;
+    }
+
+    m_mapping = static_cast<std::byte*>(mapping);
+    m_capacity = mappingLength;
+    m_used.store(0, std::memory_order_relaxed);
+}
+
+std::span<std::byte> Arena::allocate(const std::size_t size, const std::size_t alignment) {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    const auto base = reinterpret_cast<uintptr_t>(m_mapping);
+    auto used = m_used.load(std::memory_order_relaxed);
+    std::size_t start;
+
+    // Anything that allocates between the load and the exchange (including a handler on this thread) just means a retry.
+    do {
+        start = ((base + used + alignment - 1) & ~(alignment - 1)) - base;
+
+        if (start > m_capacity || size > m_capacity - start) {
+            return { };
+        }
+    } while(! m_used.compare_exchange_weak(used, start + size, std::memory_order_relaxed));
+
+    return { m_mapping + start, size };
+}
+
+void Arena::reset() {
+    m_used.store(0, std::memory_order_relaxed);
+}
+
+std::size_t Arena::get_used() const {
+    return m_used.load(std::memory_order_relaxed);
+}
+
+std::size_t Arena::get_capacity() const {
+    return m_capacity;
+}
+
+Arena::Scope::Scope(Arena& arena) : m_arena(arena), m_used(arena.get_used()) {
+}
+
+Arena::Scope::~Scope() {
+    m_arena.m_used.store(m_used, std::memory_order_relaxed);
+}
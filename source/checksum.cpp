@@ -0,0 +1,78 @@
+#include "signalsafe/checksum.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace {
+    // The bit-reversed form of the Castagnoli polynomial, 0x1EDC6F41.
+    constexpr uint32_t polynomial = 0x82F63B78;
+
+    constexpr std::array<uint32_t, 256> table = [](){
+        std::array<uint32_t, 256> result = { };
+
+        for (uint32_t index = 0; index < result.size(); ++index) {
+            uint32_t crc = index;
+
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+            }
+
+            result[index] = crc;
+        }
+
+        return result;
+    }();
+
+    uint32_t crc32c_table(uint32_t crc, std::span<const std::byte> bytes) {
+        for (const auto byte : bytes) {
+            crc = (crc >> 8) ^ table[(crc ^ static_cast<uint32_t>(byte)) & 0xFF];
+        }
+
+        return crc;
+    }
+
+#if defined(__x86_64__)
+    __attribute__((target("sse4.2")))
+    uint32_t crc32c_sse42(uint32_t crc, std::span<const std::byte> bytes) {
+        uint64_t crc64 = crc;
+
+        while(bytes.size() >= sizeof(uint64_t)) {
+            uint64_t word;
+            ::memcpy(&word, bytes.data(), sizeof(word));
+
+            crc64 = _mm_crc32_u64(crc64, word);
+            bytes = bytes.subspan(sizeof(word));
+        }
+
+        crc = static_cast<uint32_t>(crc64);
+
+        for (const auto byte : bytes) {
+            crc = _mm_crc32_u8(crc, static_cast<uint8_t>(byte));
+        }
+
+        return crc;
+    }
+
+    // Worked out before main, so that checking it from a signal handler is just a load.
+    const bool g_hasSse42 = [](){
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") != 0;
+    }();
+#endif
+}
+
+uint32_t signalsafe::checksum::crc32c(std::span<const std::byte> bytes, const uint32_t previous) {
+    const auto crc = ~previous;
+
+#if defined(__x86_64__)
+    if (g_hasSse42) {
+        return ~crc32c_sse42(crc, bytes);
+    }
+#endif
+
+    return ~crc32c_table(crc, bytes);
+}
@@ -0,0 +1,195 @@
+#include "signalsafe/directory.hpp"
+#include "signalsafe/memory.hpp"
+#include "signalsafe/string.hpp"
+
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <span>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using signalsafe::Directory;
+using signalsafe::FileHandle;
+
+namespace {
+    template <std::size_t size>
+    using null_terminated_t = std::array<char, size + 1 /* null terminator */>;
+
+    // The syscalls need null terminated strings, and the string_views we're given needn't be.
+    // Anything too long fails like the syscalls would, rather than being truncated to some other name.
+    template <std::size_t size>
+    bool to_null_terminated(std::string_view name, null_terminated_t<size>& nullTerminated) {
+        if (name.size() > size) {
+            errno = ENAMETOOLONG;
+            return false;
+        }
+
+        const auto bytesCopied = signalsafe::memory::copy_no_overlap(
+            std::span<const char>(name.data(), name.size()),
+            std::span<char>(nullTerminated.data(), size)
+        );
+
+        nullTerminated[bytesCopied] = '\0';
+        return true;
+    }
+
+    void destroy(Directory& directory) {
+        if (directory.get_file_descriptor() != -1) {
+            [[maybe_unused]] const auto closeSuccess = directory.close();
+            assert(closeSuccess);
+        }
+    }
+}
+
+Directory::~Directory() {
+    destroy(*this);
+}
+
+Directory::Directory(Directory&& other) {
+    *this = std::move(other);
+}
+
+Directory& Directory::operator=(Directory&& other) {
+    destroy(*this);
+
+    this->m_fileDescriptor = other.m_fileDescriptor;
+    other.m_fileDescriptor = -1;
+
+    return *this;
+}
+
+Directory Directory::open_existing(std::string_view path) {
+    Directory directory;
+    directory.open_existing_internal(path);
+    return directory;
+}
+
+void Directory::open_existing_internal(std::string_view path) {
+    null_terminated_t<PATH_MAX> nullTerminatedPath;
+
+    if (! to_null_terminated<PATH_MAX>(path, nullTerminatedPath)) {
+        return;
+    }
+
+    m_fileDescriptor = ::open(
+        nullTerminatedPath.data(),
+        O_PATH | O_DIRECTORY
+    );
+
+    assert(m_fileDescriptor != -1);
+}
+
+FileHandle Directory::create_and_open_at(std::string_view name, const FileHandle::Permissions permissions) const {
+    null_terminated_t<NAME_MAX> nullTerminatedName;
+
+    if (! to_null_terminated<NAME_MAX>(name, nullTerminatedName)) {
+        return FileHandle();
+    }
+
+    const auto fd = ::openat(
+        m_fileDescriptor,
+        nullTerminatedName.data(),
+        static_cast<std::underlying_type_t<decltype(permissions)>>(permissions) | O_CREAT | O_EXCL,
+        S_IRUSR | S_IWUSR
+    );
+
+    assert(fd != -1);
+
+    return FileHandle::from_file_descriptor(fd);
+}
+
+FileHandle Directory::create_and_open_temporary_at() const {
+    const auto fd = ::openat(
+        m_fileDescriptor,
+        ".",
+        O_TMPFILE | O_RDWR,
+        S_IRUSR | S_IWUSR
+    );
+
+    assert(fd != -1);
+
+    return FileHandle::from_file_descriptor(fd);
+}
+
+FileHandle Directory::open_existing_at(std::string_view name, const FileHandle::Permissions permissions) const {
+    null_terminated_t<NAME_MAX> nullTerminatedName;
+
+    if (! to_null_terminated<NAME_MAX>(name, nullTerminatedName)) {
+        return FileHandle();
+    }
+
+    const auto fd = ::openat(
+        m_fileDescriptor,
+        nullTerminatedName.data(),
+        static_cast<std::underlying_type_t<decltype(permissions)>>(permissions)
+    );
+
+    assert(fd != -1);
+
+    return FileHandle::from_file_descriptor(fd);
+}
+
+bool Directory::link_at(const FileHandle& file, std::string_view name) const {
+    // Linking the descriptor itself (AT_EMPTY_PATH) needs CAP_DAC_READ_SEARCH, but following its /proc link doesn't.
+    std::array<char, 32> procPath = { };
+    string::format("/proc/self/fd/%", procPath, int32_t{file.get_file_descriptor()});
+
+    null_terminated_t<NAME_MAX> nullTerminatedName;
+
+    if (! to_null_terminated<NAME_MAX>(name, nullTerminatedName)) {
+        return false;
+    }
+
+    return ::linkat(
+        AT_FDCWD,
+        procPath.data(),
+        m_fileDescriptor,
+        nullTerminatedName.data(),
+        AT_SYMLINK_FOLLOW
+    ) == 0;
+}
+
+bool Directory::rename_at(std::string_view oldName, std::string_view newName) const {
+    null_terminated_t<NAME_MAX> nullTerminatedOldName;
+    null_terminated_t<NAME_MAX> nullTerminatedNewName;
+
+    if (! to_null_terminated<NAME_MAX>(oldName, nullTerminatedOldName) || ! to_null_terminated<NAME_MAX>(newName, nullTerminatedNewName)) {
+        return false;
+    }
+
+    return ::renameat(
+        m_fileDescriptor,
+        nullTerminatedOldName.data(),
+        m_fileDescriptor,
+        nullTerminatedNewName.data()
+    ) == 0;
+}
+
+bool Directory::remove_at(std::string_view name) const {
+    null_terminated_t<NAME_MAX> nullTerminatedName;
+
+    if (! to_null_terminated<NAME_MAX>(name, nullTerminatedName)) {
+        return false;
+    }
+
+    return ::unlinkat(m_fileDescriptor, nullTerminatedName.data(), 0) == 0;
+}
+
+bool Directory::close() {
+    if (m_fileDescriptor == -1) {
+        return false;
+    }
+
+    // On Linux the descriptor is released even if close is interrupted, so it mustn't be retried.
+    const auto result = ::close(m_fileDescriptor) == 0 || errno == EINTR;
+    m_fileDescriptor = -1;
+    return result;
+}
+
+FileHandle::file_descriptor_t Directory::get_file_descriptor() const {
+    return m_fileDescriptor;
+}
@@ -0,0 +1,210 @@
+#include "signalsafe/encoding.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+using signalsafe::encoding::TimeDecoder;
+using signalsafe::encoding::TimeEncoder;
+using signalsafe::time::TimeSpecification;
+
+namespace {
+    constexpr uint64_t continuationBits = 0x8080808080808080;
+    constexpr int64_t nanosecondsPerSecond = 1'000'000'000;
+
+    // Wrapping, so that garbage input can't cause signed overflow.
+    int64_t wrapping_add(const int64_t lhs, const int64_t rhs) {
+        return static_cast<int64_t>(static_cast<uint64_t>(lhs) + static_cast<uint64_t>(rhs));
+    }
+
+    int64_t wrapping_subtract(const int64_t lhs, const int64_t rhs) {
+        return static_cast<int64_t>(static_cast<uint64_t>(lhs) - static_cast<uint64_t>(rhs));
+    }
+
+    int64_t to_nanoseconds(const TimeSpecification& time) {
+        return wrapping_add(static_cast<int64_t>(static_cast<uint64_t>(time.seconds) * nanosecondsPerSecond), time.nanoseconds);
+    }
+
+    TimeSpecification from_nanoseconds(const int64_t nanoseconds) {
+        // Rounds towards negative infinity, so nanoseconds is always in [0, 1e9).
+        auto seconds = nanoseconds / nanosecondsPerSecond;
+        auto remainder = nanoseconds % nanosecondsPerSecond;
+
+        if (remainder < 0) {
+            seconds -= 1;
+            remainder += nanosecondsPerSecond;
+        }
+
+        return { seconds, remainder };
+    }
+}
+
+std::size_t signalsafe::encoding::encode_varint(std::span<std::byte> target, uint64_t value) {
+    std::size_t bytesWritten = 0;
+
+    while(bytesWritten < target.size()) {
+        if (value < 0x80) {
+            target[bytesWritten] = static_cast<std::byte>(value);
+            return bytesWritten + 1;
+        }
+
+        target[bytesWritten] = static_cast<std::byte>((value & 0x7F) | 0x80);
+        value >>= 7;
+        bytesWritten += 1;
+    }
+
+    return 0;
+}
+
+std::size_t signalsafe::encoding::encode_signed_varint(std::span<std::byte> target, const int64_t value) {
+    return encode_varint(target, zigzag_encode(value));
+}
+
+std::size_t signalsafe::encoding::decode_varint(std::span<const std::byte> source, uint64_t& value) {
+    uint64_t result = 0;
+
+    for (std::size_t index = 0; index < std::min(source.size(), maxVarintSize); ++index) {
+        const auto byte = static_cast<uint64_t>(source[index]);
+        result |= (byte & 0x7F) << (7 * index);
+
+        if ((byte & 0x80) == 0) {
+            value = result;
+            return index + 1;
+        }
+    }
+
+    return 0;
+}
+
+std::size_t signalsafe::encoding::decode_signed_varint(std::span<const std::byte> source, int64_t& value) {
+    uint64_t unsignedValue;
+    const auto bytesRead = decode_varint(source, unsignedValue);
+
+    if (bytesRead != 0) {
+        value = zigzag_decode(unsignedValue);
+    }
+
+    return bytesRead;
+}
+
+std::size_t signalsafe::encoding::decode_varints(std::span<const std::byte> source, std::span<uint64_t> target, std::size_t& bytesConsumed) {
+    std::size_t valuesRead = 0;
+    bytesConsumed = 0;
+
+    while(valuesRead < target.size()) {
+        const auto remaining = source.subspan(bytesConsumed);
+
+        if (remaining.size() >= sizeof(uint64_t)) {
+            uint64_t word;
+            ::memcpy(&word, remaining.data(), sizeof(word));
+
+            // A set bit here marks the last byte of a varint.
+            const auto endBits = ~word & continuationBits;
+
+            if (endBits == continuationBits && target.size() - valuesRead >= sizeof(uint64_t)) {
+                // Eight single-byte varints.
+                for (std::size_t index = 0; index < sizeof(uint64_t); ++index) {
+                    target[valuesRead + index] = (word >> (8 * index)) & 0x7F;
+                }
+
+                valuesRead += sizeof(uint64_t);
+                bytesConsumed += sizeof(uint64_t);
+                continue;
+            }
+
+            if (endBits != 0) {
+                // The first varint ends within this word, so it can be gathered without reading any more.
+                const auto length = static_cast<std::size_t>(__builtin_ctzll(endBits) / 8) + 1;
+                uint64_t value = 0;
+
+                for (std::size_t index = 0; index < length; ++index) {
+                    value |= ((word >> (8 * index)) & 0x7F) << (7 * index);
+                }
+
+                target[valuesRead] = value;
+                valuesRead += 1;
+                bytesConsumed += length;
+                continue;
+            }
+        }
+
+        const auto bytesRead = decode_varint(remaining, target[valuesRead]);
+
+        if (bytesRead == 0) {
+            break;
+        }
+
+        valuesRead += 1;
+        bytesConsumed += bytesRead;
+    }
+
+    return valuesRead;
+}
+
+std::size_t TimeEncoder::encode(std::span<std::byte> target, const TimeSpecification& time) {
+    const auto nanoseconds = to_nanoseconds(time);
+    const auto delta = wrapping_subtract(nanoseconds, m_previousNanoseconds);
+    const auto bytesWritten = encode_signed_varint(target, wrapping_subtract(delta, m_previousDelta));
+
+    if (bytesWritten != 0) {
+        m_previousNanoseconds = nanoseconds;
+        m_previousDelta = delta;
+    }
+
+    return bytesWritten;
+}
+
+void TimeEncoder::reset() {
+    m_previousNanoseconds = 0;
+    m_previousDelta = 0;
+}
+
+std::size_t TimeDecoder::decode(std::span<const std::byte> source, TimeSpecification& time) {
+    int64_t deltaOfDelta;
+    const auto bytesRead = decode_signed_varint(source, deltaOfDelta);
+
+    if (bytesRead != 0) {
+        m_previousDelta = wrapping_add(m_previousDelta, deltaOfDelta);
+        m_previousNanoseconds = wrapping_add(m_previousNanoseconds, m_previousDelta);
+        time = from_nanoseconds(m_previousNanoseconds);
+    }
+
+    return bytesRead;
+}
+
+std::size_t TimeDecoder::decode(std::span<const std::byte> source, std::span<TimeSpecification> target, std::size_t& bytesConsumed) {
+    std::size_t timesRead = 0;
+    bytesConsumed = 0;
+
+    // Decoding the varints in bulk first keeps that loop free of the running sums' dependencies.
+    std::array<uint64_t, 64> deltasOfDeltas;
+
+    while(timesRead < target.size()) {
+        std::size_t chunkBytesConsumed = 0;
+        const auto chunkSize = decode_varints(
+            source.subspan(bytesConsumed),
+            std::span<uint64_t>(deltasOfDeltas).first(std::min(deltasOfDeltas.size(), target.size() - timesRead)),
+            chunkBytesConsumed
+        );
+
+        if (chunkSize == 0) {
+            break;
+        }
+
+        for (std::size_t index = 0; index < chunkSize; ++index) {
+            m_previousDelta = wrapping_add(m_previousDelta, zigzag_decode(deltasOfDeltas[index]));
+            m_previousNanoseconds = wrapping_add(m_previousNanoseconds, m_previousDelta);
+            target[timesRead + index] = from_nanoseconds(m_previousNanoseconds);
+        }
+
+        timesRead += chunkSize;
+        bytesConsumed += chunkBytesConsumed;
+    }
+
+    return timesRead;
+}
+
+void TimeDecoder::reset() {
+    m_previousNanoseconds = 0;
+    m_previousDelta = 0;
+}
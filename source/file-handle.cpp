@@ -0,0 +1,694 @@
+#include "signalsafe/file-handle.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using signalsafe::FileHandle;
+
+namespace {
+    // Why a transfer mechanism stopped; only Unsupported means the next one should be tried.
+    enum class TransferStop {
+        Finished,
+        EndOfFile,
+        Unsupported,
+        Failed
+    };
+
+    TransferStop to_transfer_stop(const int errorCode) {
+        switch(errorCode) {
+        case EINVAL:
+        case EXDEV:
+        case ENOSYS:
+        case EOPNOTSUPP: return TransferStop::Unsupported;
+        default: return TransferStop::Failed;
+        }
+    }
+
+    // Each of these copies as much as it can, advancing offset and shrinking length as it goes,
+    // and reports why it stopped. If the mechanism isn't supported for these files, the next one picks up where it left off.
+
+    std::size_t transfer_with_copy_file_range(const int sourceFd, const int targetFd, off_t& offset, std::size_t& length, TransferStop& stop) {
+        std::size_t bytesTransferred = 0;
+        stop = TransferStop::Finished;
+
+        while(length > 0) {
+            const auto result = ::copy_file_range(sourceFd, &offset, targetFd, nullptr, length, 0);
+
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                stop = to_transfer_stop(errno);
+                break;
+            }
+
+            // Some files (e.g. those in /proc) report 0 bytes here even when they aren't empty,
+            // so unless something has been copied already, that doesn't mean the end of the file.
+            if (result == 0) {
+                stop = bytesTransferred == 0 ? TransferStop::Unsupported : TransferStop::EndOfFile;
+                break;
+            }
+
+            bytesTransferred += static_cast<std::size_t>(result);
+            length -= static_cast<std::size_t>(result);
+        }
+
+        return bytesTransferred;
+    }
+
+    std::size_t transfer_with_sendfile(const int sourceFd, const int targetFd, off_t& offset, std::size_t& length, TransferStop& stop) {
+        std::size_t bytesTransferred = 0;
+        stop = TransferStop::Finished;
+
+        while(length > 0) {
+            const auto result = ::sendfile(targetFd, sourceFd, &offset, length);
+
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                stop = to_transfer_stop(errno);
+                break;
+            }
+
+            if (result == 0) {
+                stop = TransferStop::EndOfFile;
+                break;
+            }
+
+            bytesTransferred += static_cast<std::size_t>(result);
+            length -= static_cast<std::size_t>(result);
+        }
+
+        return bytesTransferred;
+    }
+
+    std::size_t transfer_with_splice(const int sourceFd, FileHandle& target, off_t& offset, std::size_t& length, TransferStop& stop) {
+        std::array<int, 2> pipeFds = { -1, -1 };
+
+        // Without a pipe this can't be done, but copying through a buffer still can.
+        if (::pipe2(pipeFds.data(), O_CLOEXEC) != 0) {
+            stop = TransferStop::Unsupported;
+            return 0;
+        }
+
+        auto pipeReadEnd = FileHandle::from_file_descriptor(pipeFds[0]);
+        auto pipeWriteEnd = FileHandle::from_file_descriptor(pipeFds[1]);
+
+        std::size_t bytesTransferred = 0;
+        stop = TransferStop::Finished;
+
+        while(length > 0) {
+            const auto bytesIn = ::splice(sourceFd, &offset, pipeFds[1], nullptr, length, SPLICE_F_MOVE);
+
+            if (bytesIn < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                stop = to_transfer_stop(errno);
+                break;
+            }
+
+            if (bytesIn == 0) {
+                stop = TransferStop::EndOfFile;
+                break;
+            }
+
+            auto bytesInPipe = static_cast<std::size_t>(bytesIn);
+            length -= bytesInPipe;
+
+            while(bytesInPipe > 0) {
+                const auto bytesOut = ::splice(pipeFds[0], nullptr, target.get_file_descriptor(), nullptr, bytesInPipe, SPLICE_F_MOVE);
+
+                if (bytesOut < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if (bytesOut <= 0) {
+                    break;
+                }
+
+                bytesInPipe -= static_cast<std::size_t>(bytesOut);
+                bytesTransferred += static_cast<std::size_t>(bytesOut);
+            }
+
+            // The bytes are already out of the source, so if they can't be spliced out of the pipe, copy them out.
+            while(bytesInPipe > 0) {
+                std::array<std::byte, 4096> buffer;
+                const auto bytesRead = pipeReadEnd.read(std::span<std::byte>(buffer).first(std::min(buffer.size(), bytesInPipe)));
+                const auto bytesWritten = target.write(std::span<const std::byte>(buffer.data(), bytesRead));
+
+                bytesInPipe -= bytesRead;
+                bytesTransferred += bytesWritten;
+
+                if (bytesWritten != bytesRead) {
+                    stop = TransferStop::Failed;
+                    return bytesTransferred;
+                }
+            }
+        }
+
+        return bytesTransferred;
+    }
+
+    std::size_t transfer_with_buffer(FileHandle& source, FileHandle& target, off_t& offset, std::size_t& length, TransferStop& stop) {
+        std::size_t bytesTransferred = 0;
+        stop = TransferStop::Finished;
+
+        while(length > 0) {
+            std::array<std::byte, 4096> buffer;
+            const auto bytesRead = source.read_at(offset, std::span<std::byte>(buffer).first(std::min(buffer.size(), length)));
+
+            if (bytesRead == 0) {
+                stop = TransferStop::EndOfFile;
+                break;
+            }
+
+            const auto bytesWritten = target.write(std::span<const std::byte>(buffer.data(), bytesRead));
+
+            offset += static_cast<off_t>(bytesRead);
+            length -= bytesRead;
+            bytesTransferred += bytesWritten;
+
+            if (bytesWritten != bytesRead) {
+                stop = TransferStop::Failed;
+                break;
+            }
+        }
+
+        return bytesTransferred;
+    }
+
+    void destroy(FileHandle& file) {
+        switch(file.get_destroy_action()) {
+        case FileHandle::DestroyAction::Nothing: return;
+        case FileHandle::DestroyAction::Close: {
+            if (file.get_file_descriptor() != -1) {
+                [[maybe_unused]] const auto closeSuccess = file.close();
+                assert(closeSuccess);
+            }
+        }}
+    }
+}
+
+FileHandle::~FileHandle() {
+    destroy(*this);
+}
+
+FileHandle::FileHandle(FileHandle&& other) {
+    *this = std::move(other);
+}
+
+FileHandle& FileHandle::operator=(FileHandle&& other) {
+    destroy(*this);
+
+    this->m_fileDescriptor = other.m_fileDescriptor;
+    other.m_fileDescriptor = -1;
+
+    this->m_destroyAction = other.m_destroyAction;
+    other.m_destroyAction = DestroyAction::Close;
+
+    return *this;
+}
+
+FileHandle FileHandle::create_and_open(std::string_view path, Permissions permissions) {
+    FileHandle file;
+    file.create_and_open_internal(path, permissions);
+    return file;
+}
+
+void FileHandle::create_and_open_internal(std::string_view path, Permissions permissions) {
+    m_fileDescriptor = ::open(
+        path.data(),
+        static_cast<std::underlying_type_t<decltype(permissions)>>(permissions) | O_CREAT | O_EXCL,
+        S_IRUSR | S_IWUSR
+    );
+
+    assert(m_fileDescriptor != -1);
+}
+
+FileHandle FileHandle::create_and_open_temporary(std::string_view directory) {
+    FileHandle file;
+    file.create_and_open_temporary_internal(directory);
+    return file;
+}
+
+void FileHandle::create_and_open_temporary_internal(std::string_view directory) {
+    m_fileDescriptor = ::openat(
+        AT_FDCWD,
+        directory.data(),
+        O_TMPFILE | O_RDWR,
+        S_IRUSR | S_IWUSR
+    );
+
+    assert(m_fileDescriptor != -1);
+}
+
+FileHandle FileHandle::open_existing(std::string_view path, Permissions permissions) {
+    FileHandle file;
+    file.open_existing_internal(path, permissions);
+    return file;
+}
+
+void FileHandle::open_existing_internal(std::string_view path, Permissions permissions) {
+    m_fileDescriptor = ::open(
+        path.data(),
+        static_cast<std::underlying_type_t<decltype(permissions)>>(permissions)
+    );
+
+    assert(m_fileDescriptor != -1);
+}
+
+FileHandle FileHandle::from_file_descriptor(const file_descriptor_t fd) {
+    FileHandle file;
+    file.from_file_descriptor_internal(fd);
+    return file;
+}
+
+void FileHandle::from_file_descriptor_internal(const file_descriptor_t fd) {
+    m_fileDescriptor = fd;
+}
+
+std::size_t FileHandle::read(std::span<std::byte> target) {
+    assert(m_fileDescriptor != -1);
+
+    std::size_t bytesRead = 0;
+
+    while(target.size() > 0) {
+        const auto newBytesReadOrError = ::read(
+            m_fileDescriptor,
+            target.data(),
+            target.size()
+        );
+
+        if (newBytesReadOrError < 0) {
+            // Just in case any subsequent calls modify it.
+            const auto errorCode = errno;
+
+            if (errorCode == EAGAIN || errorCode == EWOULDBLOCK) {
+                // The file is non-blocking and there's nothing more to read right now.
+                return bytesRead;
+            }
+
+            // This is the only other "acceptable" error;
+            // it can happen when a signal fires mid-read.
+            assert(errorCode == EINTR);
+
+            continue;
+        }
+
+        if (newBytesReadOrError == 0) {
+            // End of file.
+            return bytesRead;
+        }
+
+        const auto newBytesRead = static_cast<std::size_t>(newBytesReadOrError);
+        target = target.last(target.size() - newBytesRead);
+        bytesRead += newBytesRead;
+    }
+
+    return bytesRead;
+}
+
+std::size_t FileHandle::read(std::span<char> target) {
+    return read(std::as_writable_bytes(target));
+}
+
+std::size_t FileHandle::read(std::span<const iovec> targets) {
+    assert(m_fileDescriptor != -1);
+
+    std::size_t bytesRead = 0;
+
+    while(targets.size() > 0) {
+        const auto newBytesReadOrError = ::readv(
+            m_fileDescriptor,
+            targets.data(),
+            static_cast<int>(std::min<std::size_t>(targets.size(), IOV_MAX))
+        );
+
+        if (newBytesReadOrError < 0) {
+            // Just in case any subsequent calls modify it.
+            const auto errorCode = errno;
+
+            if (errorCode == EAGAIN || errorCode == EWOULDBLOCK) {
+                // The file is non-blocking and there's nothing more to read right now.
+                return bytesRead;
+            }
+
+            // This is the only other "acceptable" error;
+            // it can happen when a signal fires mid-read.
+            assert(errorCode == EINTR);
+
+            continue;
+        }
+
+        if (newBytesReadOrError == 0) {
+            // End of file.
+            return bytesRead;
+        }
+
+        auto newBytesRead = static_cast<std::size_t>(newBytesReadOrError);
+        bytesRead += newBytesRead;
+
+        while(targets.size() > 0 && newBytesRead >= targets.front().iov_len) {
+            newBytesRead -= targets.front().iov_len;
+            targets = targets.last(targets.size() - 1);
+        }
+
+        if (newBytesRead > 0) {
+            // The caller's iovecs can't be adjusted to skip what's already been read,
+            // so the rest of a partially filled target is read on its own.
+            const auto& partialTarget = targets.front();
+            const auto remainingBytes = partialTarget.iov_len - newBytesRead;
+            const auto partialBytesRead = read(std::span<std::byte>(
+                static_cast<std::byte*>(partialTarget.iov_base) + newBytesRead,
+                remainingBytes
+            ));
+
+            bytesRead += partialBytesRead;
+
+            if (partialBytesRead != remainingBytes) {
+                // End of file.
+                return bytesRead;
+            }
+
+            targets = targets.last(targets.size() - 1);
+        }
+    }
+
+    return bytesRead;
+}
+
+std::size_t FileHandle::write(std::span<const std::byte> source) {
+    std::size_t bytesWritten = 0;
+
+    while(source.size() > 0) {
+        const auto newBytesWrittenOrError = ::write(
+            m_fileDescriptor,
+            source.data(),
+            source.size()
+        );
+
+        if (newBytesWrittenOrError < 0) {
+            // Just in case any subsequent calls modify it.
+            const auto errorCode = errno;
+
+            if (errorCode == EAGAIN || errorCode == EWOULDBLOCK) {
+                // The file is non-blocking and can't take any more right now.
+                return bytesWritten;
+            }
+
+            // This is the only other "acceptable" error;
+            // it can happen when a signal fires mid-write.
+            assert(errorCode == EINTR);
+
+            continue;
+        }
+
+        const auto newBytesWritten = static_cast<std::size_t>(newBytesWrittenOrError);
+        source = source.last(source.size() - newBytesWritten);
+        bytesWritten += static_cast<size_t>(newBytesWritten);
+    }
+
+    return bytesWritten;
+}
+
+std::size_t FileHandle::write(std::span<const char> source) {
+    return write(std::as_bytes(source));
+}
+
+std::size_t FileHandle::write(std::span<const iovec> sources) {
+    std::size_t bytesWritten = 0;
+
+    while(sources.size() > 0) {
+        const auto newBytesWrittenOrError = ::writev(
+            m_fileDescriptor,
+            sources.data(),
+            static_cast<int>(std::min<std::size_t>(sources.size(), IOV_MAX))
+        );
+
+        if (newBytesWrittenOrError < 0) {
+            // Just in case any subsequent calls modify it.
+            const auto errorCode = errno;
+
+            if (errorCode == EAGAIN || errorCode == EWOULDBLOCK) {
+                // The file is non-blocking and can't take any more right now.
+                return bytesWritten;
+            }
+
+            // This is the only other "acceptable" error;
+            // it can happen when a signal fires mid-write.
+            assert(errorCode == EINTR);
+
+            continue;
+        }
+
+        auto newBytesWritten = static_cast<std::size_t>(newBytesWrittenOrError);
+        bytesWritten += newBytesWritten;
+
+        while(sources.size() > 0 && newBytesWritten >= sources.front().iov_len) {
+            newBytesWritten -= sources.front().iov_len;
+            sources = sources.last(sources.size() - 1);
+        }
+
+        if (newBytesWritten > 0) {
+            // The caller's iovecs can't be adjusted to skip what's already been written,
+            // so the rest of a partially written source is written on its own.
+            const auto& partialSource = sources.front();
+            const auto remainingBytes = partialSource.iov_len - newBytesWritten;
+            const auto partialBytesWritten = write(std::span<const std::byte>(
+                static_cast<const std::byte*>(partialSource.iov_base) + newBytesWritten,
+                remainingBytes
+            ));
+
+            bytesWritten += partialBytesWritten;
+
+            if (partialBytesWritten != remainingBytes) {
+                // The file is non-blocking and can't take any more right now.
+                return bytesWritten;
+            }
+
+            sources = sources.last(sources.size() - 1);
+        }
+    }
+
+    return bytesWritten;
+}
+
+std::size_t FileHandle::read_at(off_t offset, std::span<std::byte> target) {
+    assert(m_fileDescriptor != -1);
+
+    std::size_t bytesRead = 0;
+
+    while(target.size() > 0) {
+        const auto newBytesReadOrError = ::pread(
+            m_fileDescriptor,
+            target.data(),
+            target.size(),
+            offset
+        );
+
+        if (newBytesReadOrError < 0) {
+            // Just in case any subsequent calls modify it.
+            const auto errorCode = errno;
+
+            if (errorCode == EAGAIN || errorCode == EWOULDBLOCK) {
+                // The file is non-blocking and there's nothing more to read right now.
+                return bytesRead;
+            }
+
+            // This is the only other "acceptable" error;
+            // it can happen when a signal fires mid-read.
+            assert(errorCode == EINTR);
+
+            continue;
+        }
+
+        if (newBytesReadOrError == 0) {
+            // End of file.
+            return bytesRead;
+        }
+
+        const auto newBytesRead = static_cast<std::size_t>(newBytesReadOrError);
+        target = target.last(target.size() - newBytesRead);
+        offset += newBytesReadOrError;
+        bytesRead += newBytesRead;
+    }
+
+    return bytesRead;
+}
+
+std::size_t FileHandle::read_at(const off_t offset, std::span<char> target) {
+    return read_at(offset, std::as_writable_bytes(target));
+}
+
+std::size_t FileHandle::write_at(off_t offset, std::span<const std::byte> source) {
+    std::size_t bytesWritten = 0;
+
+    while(source.size() > 0) {
+        const auto newBytesWrittenOrError = ::pwrite(
+            m_fileDescriptor,
+            source.data(),
+            source.size(),
+            offset
+        );
+
+        if (newBytesWrittenOrError < 0) {
+            // Just in case any subsequent calls modify it.
+            const auto errorCode = errno;
+
+            if (errorCode == EAGAIN || errorCode == EWOULDBLOCK) {
+                // The file is non-blocking and can't take any more right now.
+                return bytesWritten;
+            }
+
+            // This is the only other "acceptable" error;
+            // it can happen when a signal fires mid-write.
+            assert(errorCode == EINTR);
+
+            continue;
+        }
+
+        const auto newBytesWritten = static_cast<std::size_t>(newBytesWrittenOrError);
+        source = source.last(source.size() - newBytesWritten);
+        offset += newBytesWrittenOrError;
+        bytesWritten += newBytesWritten;
+    }
+
+    return bytesWritten;
+}
+
+std::size_t FileHandle::write_at(const off_t offset, std::span<const char> source) {
+    return write_at(offset, std::as_bytes(source));
+}
+
+std::size_t FileHandle::transfer_to(FileHandle& target, off_t offset, std::size_t length) {
+    std::size_t bytesTransferred = 0;
+
+    TransferStop stop;
+
+    bytesTransferred += transfer_with_copy_file_range(m_fileDescriptor, target.m_fileDescriptor, offset, length, stop);
+
+    if (stop == TransferStop::Unsupported) {
+        bytesTransferred += transfer_with_sendfile(m_fileDescriptor, target.m_fileDescriptor, offset, length, stop);
+    }
+
+    if (stop == TransferStop::Unsupported) {
+        bytesTransferred += transfer_with_splice(m_fileDescriptor, target, offset, length, stop);
+    }
+
+    if (stop == TransferStop::Unsupported) {
+        bytesTransferred += transfer_with_buffer(*this, target, offset, length, stop);
+    }
+
+    return bytesTransferred;
+}
+
+bool FileHandle::reserve(const off_t bytes) {
+    while(true) {
+        if (::fallocate(m_fileDescriptor, 0, 0, bytes) == 0) {
+            return true;
+        }
+
+        switch(errno) {
+        case EINTR: continue;
+        case EOPNOTSUPP:
+        case ENOSYS: {
+            // The filesystem can't preallocate, but we can at least make sure the file is big enough.
+            struct stat fileStatus;
+            if (::fstat(m_fileDescriptor, &fileStatus) != 0) {
+                return false;
+            }
+
+            return fileStatus.st_size >= bytes || truncate(bytes);
+        }
+        default: return false;
+        }
+    }
+}
+
+bool FileHandle::truncate(const off_t bytes) {
+    while(true) {
+        if (::ftruncate(m_fileDescriptor, bytes) == 0) {
+            return true;
+        }
+
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+bool FileHandle::sync(const SyncMode syncMode) {
+    switch(syncMode) {
+    case SyncMode::Full:
+        return ::fsync(m_fileDescriptor) == 0;
+    case SyncMode::Data:
+        return ::fdatasync(m_fileDescriptor) == 0;
+    case SyncMode::WriteBack:
+        return start_write_back(0, 0);
+    }
+
+    assert(false);
+    return false;
+}
+
+bool FileHandle::start_write_back(const off_t offset, const off_t length) {
+    return ::sync_file_range(m_fileDescriptor, offset, length, SYNC_FILE_RANGE_WRITE) == 0;
+}
+
+bool FileHandle::set_non_blocking(const bool nonBlocking) {
+    const auto flags = ::fcntl(m_fileDescriptor, F_GETFL);
+
+    if (flags == -1) {
+        return false;
+    }
+
+    const auto newFlags = nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return newFlags == flags || ::fcntl(m_fileDescriptor, F_SETFL, newFlags) == 0;
+}
+
+bool FileHandle::close() {
+    if(m_fileDescriptor == -1) {
+        return false;
+    }
+
+    do {
+        switch(::close(m_fileDescriptor)) {
+        case EINTR: continue;
+        case 0: {
+            m_fileDescriptor = -1;
+            return true;
+        }
+        default: {
+            assert(false);
+            return false;
+        }}
+    } while(true);
+}
+
+off_t FileHandle::seek(const off_t offset, const OffsetInterpretation offsetInterpretation) {
+    return ::lseek(m_fileDescriptor, offset, static_cast<std::underlying_type_t<OffsetInterpretation>>(offsetInterpretation));
+}
+
+FileHandle::file_descriptor_t FileHandle::get_file_descriptor() const {
+    return m_fileDescriptor;
+}
+
+FileHandle::DestroyAction FileHandle::get_destroy_action() const {
+    return m_destroyAction;
+}
+
+void FileHandle::set_destroy_action(const DestroyAction destroyAction) {
+    m_destroyAction = destroyAction;
+}
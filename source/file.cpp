@@ -1,47 +1,34 @@
 #include "signalsafe/file.hpp"
+#include "signalsafe/memory.hpp"
+#include "signalsafe/string.hpp"
 
+#include <algorithm>
 #include <cassert>
-#include <cerrno>
 #include <cstring>
-#include <filesystem>
+#include <span>
 
 #include <fcntl.h>
 #include <unistd.h>
 
 using signalsafe::File;
-
-namespace {
-    void destroy(File& file) {
-        switch(file.get_destroy_action()) {
-        case File::DestroyAction::Nothing: return;
-        case File::DestroyAction::Close: {
-            if (file.get_file_descriptor() != -1) {
-                [[maybe_unused]] const auto closeSuccess = file.close();
-                assert(closeSuccess);
-            }
-        }}
-    }
-}
-
-File::~File() {
-    destroy(*this);
-}
+using signalsafe::FileHandle;
 
 File::File(File&& other) {
     *this = std::move(other);
 }
 
 File& File::operator=(File&& other) {
-    destroy(*this);
+    m_handle = std::move(other.m_handle);
 
-    this->m_fileDescriptor = other.m_fileDescriptor;
-    other.m_fileDescriptor = -1;
+    // Paths are usually far shorter than PATH_MAX, so only copy what's actually in use.
+    const auto pathLength = strnlen(other.m_path.data(), other.m_path.size() - 1 /* null terminator */);
 
-    this->m_path = other.m_path;
-    other.m_path.fill('\0');
+    memory::copy_no_overlap(
+        std::span<const char>(other.m_path.data(), pathLength + 1 /* null terminator */),
+        std::span<char>(m_path)
+    );
 
-    this->m_destroyAction = other.m_destroyAction;
-    other.m_destroyAction = DestroyAction::Close;
+    other.m_path[0] = '\0';
 
     return *this;
 }
@@ -53,31 +40,18 @@ File File::create_and_open(std::string_view path, Permissions permissions) {
 }
 
 void File::create_and_open_internal(std::string_view path, Permissions permissions) {
-    m_fileDescriptor = ::open(
-        path.data(),
-        static_cast<std::underlying_type_t<decltype(permissions)>>(permissions) | O_CREAT | O_EXCL,
-        S_IRUSR | S_IWUSR
-    );
-
-    assert(m_fileDescriptor != -1);
-
+    m_handle = FileHandle::create_and_open(path, permissions);
     ::strncpy(m_path.data(), path.data(), std::min(m_path.size(), path.size()));
 }
 
-File File::create_and_open_temporary() {
+File File::create_and_open_temporary(std::string_view directory) {
     File file;
-    file.create_and_open_temporary_internal();
+    file.create_and_open_temporary_internal(directory);
     return file;
 }
 
-void File::create_and_open_temporary_internal() {
-    m_fileDescriptor = ::open(
-        ".",
-        O_TMPFILE | O_RDWR,
-        S_IRUSR | S_IWUSR
-    );
-
-    assert(m_fileDescriptor != -1);
+void File::create_and_open_temporary_internal(std::string_view directory) {
+    m_handle = FileHandle::create_and_open_temporary(directory);
 }
 
 File File::open_existing(std::string_view path, Permissions permissions) {
@@ -87,13 +61,7 @@ File File::open_existing(std::string_view path, Permissions permissions) {
 }
 
 void File::open_existing_internal(std::string_view path, Permissions permissions) {
-    m_fileDescriptor = ::open(
-        path.data(),
-        static_cast<std::underlying_type_t<decltype(permissions)>>(permissions)
-    );
-
-    assert(m_fileDescriptor != -1);
-
+    m_handle = FileHandle::open_existing(path, permissions);
     ::strncpy(m_path.data(), path.data(), std::min(m_path.size(), path.size()));
 }
 
@@ -104,135 +72,46 @@ File File::from_file_descriptor(const file_descriptor_t fd) {
 }
 
 void File::from_file_descriptor_internal(const file_descriptor_t fd) {
-    m_fileDescriptor = fd;
-}
-
-std::size_t File::read(std::span<std::byte> target) {
-    assert(m_fileDescriptor != -1);
-
-    std::size_t bytesRead = 0;
-
-    while(target.size() > 0) {
-        const auto newBytesReadOrError = ::read(
-            m_fileDescriptor,
-            target.data(),
-            target.size()
-        );
-
-        if (newBytesReadOrError < 0) {
-            // Just in case any subsequent calls modify it.
-            [[maybe_unused]] const auto errorCode = errno;
-
-            // This is the only "acceptable" error;
-            // it can happen when a signal fires mid-read.
-            assert(errorCode == EINTR);
-
-            continue;
-        }
-
-        if (newBytesReadOrError == 0) {
-            // End of file.
-            return bytesRead;
-        }
-
-        const auto newBytesRead = static_cast<std::size_t>(newBytesReadOrError);
-        target = target.last(target.size() - newBytesRead);
-        bytesRead += newBytesRead;
-    }
-
-    return bytesRead;
-}
-
-std::size_t File::read(std::span<char> target) {
-    return read(std::as_writable_bytes(target));
+    m_handle = FileHandle::from_file_descriptor(fd);
 }
 
-std::size_t File::write(std::span<const std::byte> source) {
-    std::size_t bytesWritten = 0;
-
-    while(source.size() > 0) {
-        const auto newBytesWrittenOrError = ::write(
-            m_fileDescriptor,
-            source.data(),
-            source.size()
-        );
-
-        if (newBytesWrittenOrError < 0) {
-            // Just in case any subsequent calls modify it.
-            [[maybe_unused]] const auto errorCode = errno;
-
-            // This is the only "acceptable" error;
-            // it can happen when a signal fires mid-write.
-            assert(errorCode == EINTR);
-
-            continue;
-        }
-
-        const auto newBytesWritten = static_cast<std::size_t>(newBytesWrittenOrError);
-        source = source.last(source.size() - newBytesWritten);
-        bytesWritten += static_cast<size_t>(newBytesWritten);
+bool File::link_as(std::string_view path) {
+    if(get_file_descriptor() == -1) {
+        return false;
     }
 
-    return bytesWritten;
-}
+    // Linking the descriptor itself (AT_EMPTY_PATH) needs CAP_DAC_READ_SEARCH, but following its /proc link doesn't.
+    std::array<char, 32> procPath = { };
+    string::format("/proc/self/fd/%", procPath, int32_t{get_file_descriptor()});
 
-std::size_t File::write(std::span<const char> source) {
-    return write(std::as_bytes(source));
-}
-
-bool File::close() {
-    if(m_fileDescriptor == -1) {
+    if(::linkat(AT_FDCWD, procPath.data(), AT_FDCWD, path.data(), AT_SYMLINK_FOLLOW) != 0) {
         return false;
     }
 
-    do {
-        switch(::close(m_fileDescriptor)) {
-        case EINTR: continue;
-        case 0: {
-            m_fileDescriptor = -1;
-            return true;
-        }
-        default: {
-            assert(false);
-            return false;
-        }}
-    } while(true);
+    ::strncpy(m_path.data(), path.data(), std::min(m_path.size() - 1 /* null terminator */, path.size()));
+    m_path[std::min(m_path.size() - 1, path.size())] = '\0';
+
+    return true;
 }
 
 bool File::remove() {
-    if(m_fileDescriptor == -1 || m_path[0] == '\0') {
+    if(get_file_descriptor() == -1 || m_path[0] == '\0') {
         return false;
     }
 
     const auto result = ::unlink(m_path.data()) == 0;
 
     if(result) {
-        m_path.fill('\0');
+        m_path[0] = '\0';
     }
 
     return result;
 }
 
-off_t File::seek(const off_t offset, const OffsetInterpretation offsetInterpretation) {
-    return ::lseek(m_fileDescriptor, offset, static_cast<std::underlying_type_t<OffsetInterpretation>>(offsetInterpretation));
-}
-
-File::file_descriptor_t File::get_file_descriptor() const {
-    return m_fileDescriptor;
-}
-
 std::string_view File::get_path() const {
     return { m_path.data(), strnlen(m_path.data(), m_path.size() - 1 /* null terminator */)};
 }
 
-File::DestroyAction File::get_destroy_action() const {
-    return m_destroyAction;
-}
-
-void File::set_destroy_action(const DestroyAction destroyAction) {
-    m_destroyAction = destroyAction;
-}
-
 File& signalsafe::standard_output() {
     static auto instance = [](){
         auto f = File::from_file_descriptor(STDOUT_FILENO);
@@ -252,4 +131,3 @@ File& signalsafe::standard_error() {
 
     return instance;
 }
-
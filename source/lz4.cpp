@@ -0,0 +1,260 @@
+#include "signalsafe/lz4.hpp"
+#include "signalsafe/memory.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+#include <sys/uio.h>
+
+using signalsafe::lz4::FrameWriter;
+using signalsafe::lz4::HashTable;
+
+namespace {
+    constexpr uint32_t frameMagic = 0x184D2204;
+    constexpr uint32_t uncompressedBlockBit = 0x80000000;
+
+    // Version 01, independent blocks, no checksums, no content size, no dictionary.
+    constexpr uint8_t frameFlags = 0x60;
+
+    // 64KiB maximum block size.
+    constexpr uint8_t frameBlockDescriptor = 0x40;
+
+    // The format requires the last 5 bytes of a block to be literals, and the last match to start 12 bytes before the end.
+    constexpr std::size_t lastLiterals = 5;
+    constexpr std::size_t matchFindLimit = 12;
+    constexpr std::size_t minMatch = 4;
+    constexpr std::size_t maxOffset = 65535;
+
+    constexpr uint32_t rotate_left(const uint32_t value, const int bits) {
+        return (value << bits) | (value >> (32 - bits));
+    }
+
+    // Only ever used on the frame descriptor, which is shorter than a stripe, so only that part of xxh32 is needed.
+    constexpr uint32_t xxh32_short(const std::array<uint8_t, 2> bytes) {
+        constexpr uint32_t prime1 = 2654435761U;
+        constexpr uint32_t prime2 = 2246822519U;
+        constexpr uint32_t prime3 = 3266489917U;
+        constexpr uint32_t prime5 = 374761393U;
+
+        uint32_t hash = prime5 + static_cast<uint32_t>(bytes.size());
+
+        for (const auto byte : bytes) {
+            hash += byte * prime5;
+            hash = rotate_left(hash, 11) * prime1;
+        }
+
+        hash ^= hash >> 15;
+        hash *= prime2;
+        hash ^= hash >> 13;
+        hash *= prime3;
+        hash ^= hash >> 16;
+
+        return hash;
+    }
+
+    constexpr uint8_t headerChecksum = static_cast<uint8_t>(xxh32_short({ frameFlags, frameBlockDescriptor }) >> 8);
+
+    uint32_t read_32(const std::byte* const source) {
+        uint32_t value;
+        ::memcpy(&value, source, sizeof(value));
+        return value;
+    }
+
+    void write_32(std::byte* const target, const uint32_t value) {
+        // The frame format is little endian throughout.
+        for (std::size_t index = 0; index < sizeof(value); ++index) {
+            target[index] = static_cast<std::byte>(value >> (8 * index));
+        }
+    }
+
+    std::size_t hash(const uint32_t sequence) {
+        constexpr auto hashBits = std::countr_zero(std::tuple_size_v<HashTable>);
+        return (sequence * 2654435761U) >> (32 - hashBits);
+    }
+
+    // Writes a sequence: a token, the literals, then (unless it's the last) the match. Returns false if it doesn't fit.
+    bool write_sequence(
+        std::span<const std::byte> literals,
+        const std::size_t offset,
+        const std::size_t matchLength,
+        std::span<std::byte> target,
+        std::size_t& targetUsed) {
+
+        const auto write_length = [&](std::size_t length) {
+            for (; length >= 255; length -= 255) {
+                target[targetUsed++] = std::byte{255};
+            }
+
+            target[targetUsed++] = static_cast<std::byte>(length);
+        };
+
+        const auto matchLengthCode = matchLength == 0 ? 0 : matchLength - minMatch;
+
+        // The worst case: a token, the length bytes, the literals and an offset.
+        const auto worstCaseSize = 1 + (literals.size() / 255 + 1) + literals.size() + 2 + (matchLengthCode / 255 + 1);
+
+        if (worstCaseSize > target.size() - targetUsed) {
+            return false;
+        }
+
+        auto& token = target[targetUsed++];
+        token = static_cast<std::byte>((std::min<std::size_t>(literals.size(), 15) << 4) | std::min<std::size_t>(matchLengthCode, 15));
+
+        if (literals.size() >= 15) {
+            write_length(literals.size() - 15);
+        }
+
+        targetUsed += signalsafe::memory::copy_no_overlap(literals, target.subspan(targetUsed));
+
+        if (matchLength == 0) {
+            return true;
+        }
+
+        target[targetUsed++] = static_cast<std::byte>(offset & 0xFF);
+        target[targetUsed++] = static_cast<std::byte>(offset >> 8);
+
+        if (matchLengthCode >= 15) {
+            write_length(matchLengthCode - 15);
+        }
+
+        return true;
+    }
+}
+
+std::size_t signalsafe::lz4::compress_block(std::span<const std::byte> source, std::span<std::byte> target, HashTable& hashTable) {
+    assert(source.size() <= maxBlockSize);
+
+    std::size_t targetUsed = 0;
+    std::size_t anchor = 0;
+
+    if (source.size() > matchFindLimit) {
+        const auto matchStartLimit = source.size() - matchFindLimit;
+        const auto matchEndLimit = source.size() - lastLiterals;
+        std::size_t position = 0;
+
+        while(position < matchStartLimit) {
+            const auto sequence = read_32(source.data() + position);
+            auto& entry = hashTable[hash(sequence)];
+            const std::size_t candidate = entry;
+            entry = static_cast<uint16_t>(position);
+
+            // Entries are left over from previous blocks too, so they have to be checked properly.
+            if (candidate >= position || position - candidate > maxOffset || read_32(source.data() + candidate) != sequence) {
+                position += 1;
+                continue;
+            }
+
+            auto matchLength = minMatch;
+            while(position + matchLength < matchEndLimit && source[candidate + matchLength] == source[position + matchLength]) {
+                matchLength += 1;
+            }
+
+            if (! write_sequence(source.subspan(anchor, position - anchor), position - candidate, matchLength, target, targetUsed)) {
+                return 0;
+            }
+
+            position += matchLength;
+            anchor = position;
+        }
+    }
+
+    if (! write_sequence(source.subspan(anchor), 0, 0, target, targetUsed)) {
+        return 0;
+    }
+
+    return targetUsed;
+}
+
+std::size_t signalsafe::lz4::encode_frame_header(std::span<std::byte> target) {
+    constexpr std::size_t headerSize = 7;
+
+    if (target.size() < headerSize) {
+        return 0;
+    }
+
+    write_32(target.data(), frameMagic);
+    target[4] = static_cast<std::byte>(frameFlags);
+    target[5] = static_cast<std::byte>(frameBlockDescriptor);
+    target[6] = static_cast<std::byte>(headerChecksum);
+
+    return headerSize;
+}
+
+FrameWriter::FrameWriter(FileHandle file) : m_file(std::move(file)) {
+    std::array<std::byte, 7> header;
+    [[maybe_unused]] const auto headerSize = encode_frame_header(header);
+    assert(headerSize == header.size());
+
+    m_file.write(std::span<const std::byte>(header));
+}
+
+FrameWriter::~FrameWriter() {
+    if (! m_finished && m_file.get_file_descriptor() != -1) {
+        finish();
+    }
+}
+
+std::size_t FrameWriter::write(std::span<const std::byte> source) {
+    assert(! m_finished);
+
+    std::size_t bytesAccepted = 0;
+
+    while(! source.empty()) {
+        const auto bytesCopied = memory::copy_no_overlap(source, std::span<std::byte>(m_input).subspan(m_inputUsed));
+
+        m_inputUsed += bytesCopied;
+        bytesAccepted += bytesCopied;
+        source = source.subspan(bytesCopied);
+
+        if (m_inputUsed == m_input.size() && ! flush()) {
+            break;
+        }
+    }
+
+    return bytesAccepted;
+}
+
+std::size_t FrameWriter::write(std::span<const char> source) {
+    return write(std::as_bytes(source));
+}
+
+bool FrameWriter::flush() {
+    if (m_inputUsed == 0) {
+        return true;
+    }
+
+    const auto input = std::span<const std::byte>(m_input.data(), m_inputUsed);
+
+    // Only keep the compressed bytes if they're actually smaller; otherwise the block is stored as is.
+    const auto compressedSize = compress_block(input, std::span<std::byte>(m_output.data(), m_inputUsed - 1), m_hashTable);
+    const auto isCompressed = compressedSize != 0;
+    const auto block = isCompressed ? std::span<const std::byte>(m_output.data(), compressedSize) : input;
+
+    std::array<std::byte, sizeof(uint32_t)> blockSize;
+    write_32(blockSize.data(), static_cast<uint32_t>(block.size()) | (isCompressed ? 0 : uncompressedBlockBit));
+
+    const std::array<iovec, 2> sources = {{
+        { blockSize.data(), blockSize.size() },
+        { const_cast<std::byte*>(block.data()), block.size() }
+    }};
+
+    m_inputUsed = 0;
+
+    return m_file.write(std::span<const iovec>(sources)) == blockSize.size() + block.size();
+}
+
+bool FrameWriter::finish() {
+    assert(! m_finished);
+
+    const auto flushSuccess = flush();
+    m_finished = true;
+
+    constexpr std::array<std::byte, sizeof(uint32_t)> endMark = { };
+    return m_file.write(std::span<const std::byte>(endMark)) == endMark.size() && flushSuccess;
+}
+
+signalsafe::FileHandle& FrameWriter::get_file() {
+    return m_file;
+}
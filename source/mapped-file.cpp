@@ -0,0 +1,115 @@
+#include "signalsafe/mapped-file.hpp"
+
+#include <cassert>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using signalsafe::FileHandle;
+using signalsafe::MappedFile;
+
+namespace {
+    int to_protection(const FileHandle::Permissions permissions) {
+        switch(permissions) {
+        case FileHandle::Permissions::ReadOnly: return PROT_READ;
+        // mmap can't map a page without being able to read it, so this needs a file that's open for reading too.
+        case FileHandle::Permissions::WriteOnly: return PROT_READ | PROT_WRITE;
+        case FileHandle::Permissions::ReadWrite: return PROT_READ | PROT_WRITE;
+        }
+
+        assert(false);
+        return PROT_NONE;
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (m_mapping != nullptr) {
+        [[maybe_unused]] const auto unmapSuccess = unmap();
+        assert(unmapSuccess);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    if (m_mapping != nullptr) {
+        [[maybe_unused]] const auto unmapSuccess = unmap();
+        assert(unmapSuccess);
+    }
+
+    this->m_mapping = other.m_mapping;
+    other.m_mapping = nullptr;
+
+    this->m_mappingLength = other.m_mappingLength;
+    other.m_mappingLength = 0;
+
+    this->m_bytes = other.m_bytes;
+    other.m_bytes = { };
+
+    return *this;
+}
+
+MappedFile MappedFile::map(const FileHandle& file, const off_t offset, const std::size_t length, const FileHandle::Permissions permissions) {
+    MappedFile mappedFile;
+    mappedFile.map_internal(file, offset, length, permissions);
+    return mappedFile;
+}
+
+void MappedFile::map_internal(const FileHandle& file, const off_t offset, const std::size_t length, const FileHandle::Permissions permissions) {
+    assert(offset >= 0);
+    assert(length > 0);
+
+    const auto pageSize = static_cast<off_t>(::sysconf(_SC_PAGESIZE));
+    const auto offsetIntoMapping = static_cast<std::size_t>(offset % pageSize);
+
+    const auto mappingLength = offsetIntoMapping + length;
+
+    void* const mapping = ::mmap(
+        nullptr,
+        mappingLength,
+        to_protection(permissions),
+        MAP_SHARED,
+        file.get_file_descriptor(),
+        offset - static_cast<off_t>(offsetIntoMapping)
+    );
+
+    // Left as nothing mapped, rather than holding on to MAP_FAILED.
+    if (mapping == MAP_FAILED) {
+        return;
+    }
+
+    m_mapping = static_cast<std::byte*>(mapping);
+    m_mappingLength = mappingLength;
+    m_bytes = { m_mapping + offsetIntoMapping, length };
+}
+
+std::span<std::byte> MappedFile::get_bytes() const {
+    return m_bytes;
+}
+
+bool MappedFile::sync(const SyncMode syncMode) {
+    if (m_mapping == nullptr) {
+        return false;
+    }
+
+    return ::msync(m_mapping, m_mappingLength, static_cast<std::underlying_type_t<SyncMode>>(syncMode)) == 0;
+}
+
+bool MappedFile::unmap() {
+    if (m_mapping == nullptr) {
+        return false;
+    }
+
+    if (::munmap(m_mapping, m_mappingLength) != 0) {
+        return false;
+    }
+
+    m_mapping = nullptr;
+    m_mappingLength = 0;
+    m_bytes = { };
+
+    return true;
+}
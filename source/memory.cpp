@@ -1,16 +1,812 @@
 #include <signalsafe/memory.hpp>
 
-#include <cstring>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+// Everything here is written by hand, rather than calling memcpy/memmove, because those aren't guaranteed
+// to be signal-safe and may be resolved lazily (via IFUNC) the first time they're called, e.g. in a handler.
+//
+// The build stops the compiler from turning any of these loops back into calls to them (see CMakeLists.txt).
+
+using signalsafe::memory::impl::CopyKernel;
+
+namespace {
+    using copy_function_t = void (*)(std::byte* target, const std::byte* source, std::size_t size);
+
+    // 16 bytes at a time, as a building block for copies of up to 64 bytes.
+#if defined(__x86_64__)
+    using chunk_t = __m128i;
+
+    chunk_t load_chunk(const std::byte* const source) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    }
+
+    void store_chunk(std::byte* const target, const chunk_t chunk) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), chunk);
+    }
+#else
+    struct chunk_t {
+        uint64_t low;
+        uint64_t high;
+    };
+
+    chunk_t load_chunk(const std::byte* const source) {
+        chunk_t chunk;
+        __builtin_memcpy(&chunk.low, source, sizeof(uint64_t));
+        __builtin_memcpy(&chunk.high, source + sizeof(uint64_t), sizeof(uint64_t));
+        return chunk;
+    }
+
+    void store_chunk(std::byte* const target, const chunk_t chunk) {
+        __builtin_memcpy(target, &chunk.low, sizeof(uint64_t));
+        __builtin_memcpy(target + sizeof(uint64_t), &chunk.high, sizeof(uint64_t));
+    }
+#endif
+
+    template <typename T>
+    T load(const std::byte* const source) {
+        T value;
+        __builtin_memcpy(&value, source, sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void store(std::byte* const target, const T value) {
+        __builtin_memcpy(target, &value, sizeof(T));
+    }
+
+    // Copies of up to 64 bytes, as a pair of (possibly overlapping) loads and stores from each end.
+    // Everything is loaded before anything is stored, so this is safe even if the source and target overlap.
+    void copy_small(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        if (size >= 32) {
+            const auto first0 = load_chunk(source);
+            const auto first1 = load_chunk(source + 16);
+            const auto last0 = load_chunk(source + size - 32);
+            const auto last1 = load_chunk(source + size - 16);
+            store_chunk(target, first0);
+            store_chunk(target + 16, first1);
+            store_chunk(target + size - 32, last0);
+            store_chunk(target + size - 16, last1);
+        } else if (size >= 16) {
+            const auto first = load_chunk(source);
+            const auto last = load_chunk(source + size - 16);
+            store_chunk(target, first);
+            store_chunk(target + size - 16, last);
+        } else if (size >= 8) {
+            const auto first = load<uint64_t>(source);
+            const auto last = load<uint64_t>(source + size - 8);
+            store(target, first);
+            store(target + size - 8, last);
+        } else if (size >= 4) {
+            const auto first = load<uint32_t>(source);
+            const auto last = load<uint32_t>(source + size - 4);
+            store(target, first);
+            store(target + size - 4, last);
+        } else if (size > 0) {
+            const auto first = source[0];
+            const auto middle = source[size / 2];
+            const auto last = source[size - 1];
+            target[0] = first;
+            target[size / 2] = middle;
+            target[size - 1] = last;
+        }
+    }
+
+    // The bulk kernels below all copy more than 64 bytes in 64-byte blocks.
+    //
+    // Forwards, the last block is loaded up front and stored at the very end, so the tail needs no special casing
+    // and a target that overlaps the start of the source can't clobber it before it's read.
+    // Backwards is the mirror image, for a target that overlaps the end of the source.
+
+    void copy_forward_portable(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        const auto last0 = load_chunk(source + size - 64);
+        const auto last1 = load_chunk(source + size - 48);
+        const auto last2 = load_chunk(source + size - 32);
+        const auto last3 = load_chunk(source + size - 16);
+
+        for (std::size_t offset = 0; offset < size - 64; offset += 64) {
+            const auto block0 = load_chunk(source + offset);
+            const auto block1 = load_chunk(source + offset + 16);
+            const auto block2 = load_chunk(source + offset + 32);
+            const auto block3 = load_chunk(source + offset + 48);
+            store_chunk(target + offset, block0);
+            store_chunk(target + offset + 16, block1);
+            store_chunk(target + offset + 32, block2);
+            store_chunk(target + offset + 48, block3);
+        }
+
+        store_chunk(target + size - 64, last0);
+        store_chunk(target + size - 48, last1);
+        store_chunk(target + size - 32, last2);
+        store_chunk(target + size - 16, last3);
+    }
+
+    void copy_backward_portable(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        const auto first0 = load_chunk(source);
+        const auto first1 = load_chunk(source + 16);
+        const auto first2 = load_chunk(source + 32);
+        const auto first3 = load_chunk(source + 48);
+
+        for (std::size_t end = size; end > 64; end -= 64) {
+            const auto block0 = load_chunk(source + end - 64);
+            const auto block1 = load_chunk(source + end - 48);
+            const auto block2 = load_chunk(source + end - 32);
+            const auto block3 = load_chunk(source + end - 16);
+            store_chunk(target + end - 64, block0);
+            store_chunk(target + end - 48, block1);
+            store_chunk(target + end - 32, block2);
+            store_chunk(target + end - 16, block3);
+        }
+
+        store_chunk(target, first0);
+        store_chunk(target + 16, first1);
+        store_chunk(target + 32, first2);
+        store_chunk(target + 48, first3);
+    }
+
+    // The streaming kernels below copy at least streamingThreshold bytes, with non-temporal stores that bypass the cache.
+    //
+    // Up to 63 bytes are copied normally first, so that every non-temporal store fills (part of) a cache line that's
+    // aligned to 64 bytes; the write combining buffers then go straight to memory a whole line at a time.
+    // Whatever's left over at the end (again, less than 64 bytes) is copied normally too.
+    //
+    // Non-temporal stores are weakly ordered, so they're fenced before returning, lest a later store
+    // (e.g. marking the copy as done) become visible before them.
+
+#if defined(__x86_64__)
+    std::size_t get_streaming_head_size(const std::byte* const target) {
+        return (64 - (reinterpret_cast<uintptr_t>(target) & 63)) & 63;
+    }
+
+    // SSE2 is part of x86-64, so the portable kernels above already use it.
+
+    void copy_streaming_sse2(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        std::size_t offset = get_streaming_head_size(target);
+        copy_small(target, source, offset);
+
+        for (; size - offset >= 64; offset += 64) {
+            const auto block0 = load_chunk(source + offset);
+            const auto block1 = load_chunk(source + offset + 16);
+            const auto block2 = load_chunk(source + offset + 32);
+            const auto block3 = load_chunk(source + offset + 48);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(target + offset), block0);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(target + offset + 16), block1);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(target + offset + 32), block2);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(target + offset + 48), block3);
+        }
+
+        copy_small(target + offset, source + offset, size - offset);
+        _mm_sfence();
+    }
+
+    __attribute__((target("avx2")))
+    void copy_forward_avx2(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        const auto last0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + size - 64));
+        const auto last1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + size - 32));
+
+        for (std::size_t offset = 0; offset < size - 64; offset += 64) {
+            const auto block0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+            const auto block1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset + 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + offset), block0);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + offset + 32), block1);
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + size - 64), last0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + size - 32), last1);
+    }
+
+    __attribute__((target("avx2")))
+    void copy_backward_avx2(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        const auto first0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+        const auto first1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 32));
+
+        for (std::size_t end = size; end > 64; end -= 64) {
+            const auto block0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + end - 64));
+            const auto block1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + end - 32));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + end - 64), block0);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + end - 32), block1);
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target), first0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + 32), first1);
+    }
+
+    __attribute__((target("avx512f")))
+    void copy_forward_avx512(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        const auto last = _mm512_loadu_si512(source + size - 64);
+
+        for (std::size_t offset = 0; offset < size - 64; offset += 64) {
+            _mm512_storeu_si512(target + offset, _mm512_loadu_si512(source + offset));
+        }
+
+        _mm512_storeu_si512(target + size - 64, last);
+    }
+
+    __attribute__((target("avx512f")))
+    void copy_backward_avx512(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        const auto first = _mm512_loadu_si512(source);
+
+        for (std::size_t end = size; end > 64; end -= 64) {
+            _mm512_storeu_si512(target + end - 64, _mm512_loadu_si512(source + end - 64));
+        }
+
+        _mm512_storeu_si512(target, first);
+    }
+
+    __attribute__((target("avx2")))
+    void copy_streaming_avx2(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        std::size_t offset = get_streaming_head_size(target);
+        copy_small(target, source, offset);
+
+        for (; size - offset >= 64; offset += 64) {
+            const auto block0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+            const auto block1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset + 32));
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(target + offset), block0);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(target + offset + 32), block1);
+        }
+
+        copy_small(target + offset, source + offset, size - offset);
+        _mm_sfence();
+    }
+
+    __attribute__((target("avx512f")))
+    void copy_streaming_avx512(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        std::size_t offset = get_streaming_head_size(target);
+        copy_small(target, source, offset);
+
+        for (; size - offset >= 64; offset += 64) {
+            _mm512_stream_si512(reinterpret_cast<__m512i*>(target + offset), _mm512_loadu_si512(source + offset));
+        }
+
+        copy_small(target + offset, source + offset, size - offset);
+        _mm_sfence();
+    }
+#endif
+
+    // Only ever changed by initialise (or tests), before any handlers are installed; relaxed is plenty.
+    std::atomic<copy_function_t> g_copyForward = copy_forward_portable;
+    std::atomic<copy_function_t> g_copyBackward = copy_backward_portable;
+#if defined(__x86_64__)
+    std::atomic<copy_function_t> g_copyStreaming = copy_streaming_sse2;
+    std::atomic<CopyKernel> g_copyKernel = CopyKernel::Sse2;
+#else
+    std::atomic<copy_function_t> g_copyStreaming = copy_forward_portable;
+    std::atomic<CopyKernel> g_copyKernel = CopyKernel::Portable;
+#endif
+
+    void copy_forward(std::byte* const target, const std::byte* const source, const std::size_t size) {
+        if (size <= 64) {
+            return copy_small(target, source, size);
+        }
+
+        g_copyForward.load(std::memory_order_relaxed)(target, source, size);
+    }
+
+    // try_copy works a page at a time, since that's the granularity memory is readable at.
+    // This is the smallest page size Linux uses; bigger pages just mean more (harmless) splits.
+    constexpr std::size_t probeGranularity = 4096;
+
+    // Only ever changed by initialise, before any handlers are installed.
+    std::atomic<bool> g_hasProcessVmReadv = true;
+    std::atomic<int> g_probePipeRead = -1;
+    std::atomic<int> g_probePipeWrite = -1;
+
+    std::size_t get_probe_chunk_size(const std::byte* const source, const std::size_t size) {
+        return std::min(size, probeGranularity - reinterpret_cast<uintptr_t>(source) % probeGranularity);
+    }
+
+    // Reads from this process as though it were another, so unreadable memory is an error (EFAULT) rather than a fault.
+    // A partial read never splits an iovec, so the source is split up by page to find exactly where it stops being readable.
+    std::size_t try_copy_with_process_vm_readv(std::span<const std::byte> source, std::span<std::byte> target, bool& isSupported) {
+        const auto n = std::min(source.size_bytes(), target.size_bytes());
+        std::size_t bytesCopied = 0;
+        isSupported = true;
+
+        while(bytesCopied < n) {
+            std::array<iovec, 64> remotes;
+            std::size_t remoteCount = 0;
+            std::size_t remoteSize = 0;
+
+            while(remoteCount < remotes.size() && bytesCopied + remoteSize < n) {
+                const auto chunkStart = source.data() + bytesCopied + remoteSize;
+                const auto chunkSize = get_probe_chunk_size(chunkStart, n - bytesCopied - remoteSize);
+
+                remotes[remoteCount++] = { const_cast<std::byte*>(chunkStart), chunkSize };
+                remoteSize += chunkSize;
+            }
+
+            const iovec local = { target.data() + bytesCopied, remoteSize };
+            const auto result = ::process_vm_readv(::getpid(), &local, 1, remotes.data(), remoteCount, 0);
+
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                isSupported = errno != ENOSYS && errno != EPERM;
+                break;
+            }
+
+            bytesCopied += static_cast<std::size_t>(result);
+
+            if (static_cast<std::size_t>(result) < remoteSize) {
+                break;
+            }
+        }
+
+        return bytesCopied;
+    }
+
+    // The kernels below (fill, compare and the finds) only use SSE2, which every x86-64 CPU has, so there's no dispatch.
+    // Elsewhere they work a word at a time instead.
+
+    constexpr uint64_t repeatedBytes = 0x0101010101010101;
+
+#if ! defined(__x86_64__)
+    constexpr uint64_t highBits = 0x8080808080808080;
+
+    // Whether any byte in the word is zero.
+    bool has_zero_byte(const uint64_t word) {
+        return ((word - repeatedBytes) & ~word & highBits) != 0;
+    }
+#endif
+
+    std::size_t find_scalar(const std::byte* const haystack, const std::size_t size, const std::byte needle) {
+        for (std::size_t index = 0; index < size; ++index) {
+            if (haystack[index] == needle) {
+                return index;
+            }
+        }
+
+        return size;
+    }
+
+    int compare_scalar(const std::byte* const lhs, const std::byte* const rhs, const std::size_t size) {
+        for (std::size_t index = 0; index < size; ++index) {
+            if (lhs[index] != rhs[index]) {
+                return lhs[index] < rhs[index] ? -1 : 1;
+            }
+        }
+
+        return 0;
+    }
+
+    void fill_bytes(std::byte* const target, const std::size_t size, const std::byte value) {
+        if (size >= 16) {
+#if defined(__x86_64__)
+            const auto chunk = _mm_set1_epi8(static_cast<char>(value));
+#else
+            const auto word = repeatedBytes * static_cast<uint64_t>(value);
+            const chunk_t chunk = { word, word };
+#endif
+
+            // The last chunk may overlap the one before it, which saves a tail loop.
+            for (std::size_t offset = 0; offset < size - 16; offset += 16) {
+                store_chunk(target + offset, chunk);
+            }
+
+            store_chunk(target + size - 16, chunk);
+        } else if (size >= 8) {
+            const auto word = repeatedBytes * static_cast<uint64_t>(value);
+            store(target, word);
+            store(target + size - 8, word);
+        } else if (size >= 4) {
+            const auto word = static_cast<uint32_t>(repeatedBytes * static_cast<uint64_t>(value));
+            store(target, word);
+            store(target + size - 4, word);
+        } else if (size > 0) {
+            target[0] = value;
+            target[size / 2] = value;
+            target[size - 1] = value;
+        }
+    }
+
+    int compare_bytes(const std::byte* const lhs, const std::byte* const rhs, const std::size_t size) {
+        std::size_t offset = 0;
+
+#if defined(__x86_64__)
+        for (; size - offset >= 16; offset += 16) {
+            const auto equalBytes = _mm_movemask_epi8(_mm_cmpeq_epi8(load_chunk(lhs + offset), load_chunk(rhs + offset)));
+
+            if (equalBytes != 0xFFFF) {
+                const auto index = offset + static_cast<std::size_t>(__builtin_ctz(~equalBytes));
+                return lhs[index] < rhs[index] ? -1 : 1;
+            }
+        }
+#else
+        for (; size - offset >= 8; offset += 8) {
+            if (load<uint64_t>(lhs + offset) != load<uint64_t>(rhs + offset)) {
+                break;
+            }
+        }
+#endif
+
+        return compare_scalar(lhs + offset, rhs + offset, size - offset);
+    }
+
+    std::size_t find_byte(const std::byte* const haystack, const std::size_t size, const std::byte needle) {
+        std::size_t offset = 0;
+
+#if defined(__x86_64__)
+        const auto needles = _mm_set1_epi8(static_cast<char>(needle));
+
+        for (; size - offset >= 16; offset += 16) {
+            const auto matches = _mm_movemask_epi8(_mm_cmpeq_epi8(load_chunk(haystack + offset), needles));
+
+            if (matches != 0) {
+                return offset + static_cast<std::size_t>(__builtin_ctz(matches));
+            }
+        }
+#else
+        const auto needles = repeatedBytes * static_cast<uint64_t>(needle);
+
+        for (; size - offset >= 8; offset += 8) {
+            if (has_zero_byte(load<uint64_t>(haystack + offset) ^ needles)) {
+                break;
+            }
+        }
+#endif
+
+        return offset + find_scalar(haystack + offset, size - offset, needle);
+    }
+
+    // Reads whole aligned chunks, which can't cross into another page, so it can safely read a little either side.
+    __attribute__((no_sanitize_address))
+    std::size_t find_byte_unbounded(const std::byte* const haystack, const std::byte needle) {
+#if defined(__x86_64__)
+        const auto misalignment = reinterpret_cast<uintptr_t>(haystack) % 16;
+        const auto needles = _mm_set1_epi8(static_cast<char>(needle));
+        auto chunk = haystack - misalignment;
+
+        // Bytes before the haystack don't count.
+        auto matches = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(chunk)), needles)) >> misalignment;
+
+        if (matches != 0) {
+            return static_cast<std::size_t>(__builtin_ctz(matches));
+        }
+
+        while(true) {
+            chunk += 16;
+            matches = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(chunk)), needles));
+
+            if (matches != 0) {
+                return static_cast<std::size_t>(chunk - haystack) + static_cast<std::size_t>(__builtin_ctz(matches));
+            }
+        }
+#else
+        std::size_t index = 0;
+
+        while(haystack[index] != needle) {
+            index += 1;
+        }
+
+        return index;
+#endif
+    }
+
+    std::size_t find_any_byte(const std::byte* const haystack, const std::size_t size, std::span<const std::byte> needles) {
+        std::size_t offset = 0;
+
+#if defined(__x86_64__)
+        // A handful of needles can each be compared against a whole chunk at once.
+        constexpr std::size_t maxVectorNeedles = 8;
+
+        if (needles.size() <= maxVectorNeedles) {
+            __m128i needleChunks[maxVectorNeedles];
+
+            for (std::size_t index = 0; index < needles.size(); ++index) {
+                needleChunks[index] = _mm_set1_epi8(static_cast<char>(needles[index]));
+            }
+
+            for (; size - offset >= 16; offset += 16) {
+                const auto chunk = load_chunk(haystack + offset);
+                auto matches = _mm_setzero_si128();
+
+                for (std::size_t index = 0; index < needles.size(); ++index) {
+                    matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, needleChunks[index]));
+                }
+
+                const auto matchBits = _mm_movemask_epi8(matches);
+
+                if (matchBits != 0) {
+                    return offset + static_cast<std::size_t>(__builtin_ctz(matchBits));
+                }
+            }
+        }
+#endif
+
+        // Otherwise, a bit per possible byte value says whether it's a needle.
+        std::array<uint64_t, 4> isNeedle = { };
+
+        for (const auto needle : needles) {
+            const auto value = static_cast<uint8_t>(needle);
+            isNeedle[value / 64] |= uint64_t{1} << (value % 64);
+        }
+
+        for (; offset < size; ++offset) {
+            const auto value = static_cast<uint8_t>(haystack[offset]);
+
+            if ((isNeedle[value / 64] >> (value % 64)) & 1) {
+                return offset;
+            }
+        }
+
+        return size;
+    }
+
+    std::size_t find_byte_sequence(const std::byte* const haystack, const std::size_t size, std::span<const std::byte> needle) {
+        // Candidates are where both the first and last bytes of the needle match; only those get compared in full.
+        // That filters out almost everything, even when the first byte on its own is common.
+        const auto needleSize = needle.size();
+        const auto lastStart = size - needleSize;
+        std::size_t offset = 0;
+
+#if defined(__x86_64__)
+        const auto firstBytes = _mm_set1_epi8(static_cast<char>(needle.front()));
+        const auto lastBytes = _mm_set1_epi8(static_cast<char>(needle.back()));
+
+        for (; lastStart - offset >= 16; offset += 16) {
+            const auto firstMatches = _mm_cmpeq_epi8(load_chunk(haystack + offset), firstBytes);
+            const auto lastMatches = _mm_cmpeq_epi8(load_chunk(haystack + offset + needleSize - 1), lastBytes);
+            auto candidates = _mm_movemask_epi8(_mm_and_si128(firstMatches, lastMatches));
+
+            while(candidates != 0) {
+                const auto start = offset + static_cast<std::size_t>(__builtin_ctz(candidates));
+
+                if (compare_bytes(haystack + start + 1, needle.data() + 1, needleSize - 2) == 0) {
+                    return start;
+                }
+
+                candidates &= candidates - 1;
+            }
+        }
+#endif
+
+        while(offset <= lastStart) {
+            offset += find_byte(haystack + offset, lastStart - offset + 1, needle.front());
+
+            if (offset > lastStart) {
+                break;
+            }
+
+            if (haystack[offset + needleSize - 1] == needle.back() && compare_bytes(haystack + offset + 1, needle.data() + 1, needleSize - 2) == 0) {
+                return offset;
+            }
+
+            offset += 1;
+        }
+
+        return size;
+    }
+}
 
 std::size_t signalsafe::memory::copy_no_overlap(std::span<const std::byte> source, std::span<std::byte> target) {
     const auto n = std::min(source.size_bytes(), target.size_bytes());
-    memcpy(target.data(), source.data(), n);
+    copy_forward(target.data(), source.data(), n);
     return n;
 }
 
 std::size_t signalsafe::memory::copy_with_overlap(std::span<const std::byte> source, std::span<std::byte> target) {
     const auto n = std::min(source.size_bytes(), target.size_bytes());
-    memmove(target.data(), source.data(), n);
+
+    // Only a target that starts inside the source has to be copied backwards.
+    const auto targetOffset = reinterpret_cast<uintptr_t>(target.data()) - reinterpret_cast<uintptr_t>(source.data());
+
+    if (n <= 64 || targetOffset == 0 || targetOffset >= n) {
+        copy_forward(target.data(), source.data(), n);
+    } else {
+        g_copyBackward.load(std::memory_order_relaxed)(target.data(), source.data(), n);
+    }
+
     return n;
 }
 
+std::size_t signalsafe::memory::copy_streaming(std::span<const std::byte> source, std::span<std::byte> target) {
+    const auto n = std::min(source.size_bytes(), target.size_bytes());
+
+    if (n < streamingThreshold) {
+        copy_forward(target.data(), source.data(), n);
+    } else {
+        g_copyStreaming.load(std::memory_order_relaxed)(target.data(), source.data(), n);
+    }
+
+    return n;
+}
+
+std::size_t signalsafe::memory::try_copy(std::span<const std::byte> source, std::span<std::byte> target) {
+    if (g_hasProcessVmReadv.load(std::memory_order_relaxed)) {
+        bool isSupported;
+        const auto bytesCopied = try_copy_with_process_vm_readv(source, target, isSupported);
+
+        if (isSupported) {
+            return bytesCopied;
+        }
+    }
+
+    return impl::try_copy_with_pipe(source, target);
+}
+
+std::size_t signalsafe::memory::impl::try_copy_with_pipe(std::span<const std::byte> source, std::span<std::byte> target) {
+    const auto probePipeRead = g_probePipeRead.load(std::memory_order_relaxed);
+    const auto probePipeWrite = g_probePipeWrite.load(std::memory_order_relaxed);
+
+    if (probePipeWrite == -1) {
+        return 0;
+    }
+
+    const auto n = std::min(source.size_bytes(), target.size_bytes());
+    std::size_t bytesCopied = 0;
+
+    while(bytesCopied < n) {
+        const auto chunkStart = source.data() + bytesCopied;
+        const auto chunkSize = get_probe_chunk_size(chunkStart, n - bytesCopied);
+
+        // The kernel reads the byte on our behalf, so if its page is unreadable the write fails (EFAULT) rather than faulting.
+        // Other threads share the pipe, so whatever byte gets read back out is meaningless; it's only emptied so it never fills up.
+        const auto result = ::write(probePipeWrite, chunkStart, 1);
+
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            if (errno == EAGAIN) {
+                std::array<std::byte, 256> drain;
+                while(::read(probePipeRead, drain.data(), drain.size()) > 0);
+                continue;
+            }
+
+            break;
+        }
+
+        std::byte discarded;
+        [[maybe_unused]] const auto readResult = ::read(probePipeRead, &discarded, 1);
+
+        copy_forward(target.data() + bytesCopied, chunkStart, chunkSize);
+        bytesCopied += chunkSize;
+    }
+
+    return bytesCopied;
+}
+
+std::size_t signalsafe::memory::fill(std::span<std::byte> target, const std::byte value) {
+    fill_bytes(target.data(), target.size_bytes(), value);
+    return target.size_bytes();
+}
+
+int signalsafe::memory::compare(std::span<const std::byte> lhs, std::span<const std::byte> rhs) {
+    const auto result = compare_bytes(lhs.data(), rhs.data(), std::min(lhs.size_bytes(), rhs.size_bytes()));
+
+    if (result != 0 || lhs.size_bytes() == rhs.size_bytes()) {
+        return result;
+    }
+
+    return lhs.size_bytes() < rhs.size_bytes() ? -1 : 1;
+}
+
+std::size_t signalsafe::memory::find(std::span<const std::byte> haystack, const std::byte needle) {
+    return find_byte(haystack.data(), haystack.size_bytes(), needle);
+}
+
+std::size_t signalsafe::memory::find_unbounded(const std::byte* const haystack, const std::byte needle) {
+    return find_byte_unbounded(haystack, needle);
+}
+
+std::size_t signalsafe::memory::find_any(std::span<const std::byte> haystack, std::span<const std::byte> needles) {
+    if (needles.size() == 1) {
+        return find(haystack, needles.front());
+    }
+
+    return find_any_byte(haystack.data(), haystack.size_bytes(), needles);
+}
+
+std::size_t signalsafe::memory::find_sequence(std::span<const std::byte> haystack, std::span<const std::byte> needle) {
+    if (needle.empty()) {
+        return 0;
+    }
+
+    if (needle.size() > haystack.size()) {
+        return haystack.size();
+    }
+
+    if (needle.size() == 1) {
+        return find(haystack, needle.front());
+    }
+
+    return find_byte_sequence(haystack.data(), haystack.size_bytes(), needle);
+}
+
+void signalsafe::memory::initialise() {
+    __builtin_cpu_init();
+
+    // Reading a byte of our own says whether process_vm_readv can be used at all (e.g. it may be blocked by seccomp).
+    {
+        std::byte probe;
+        bool isSupported;
+        try_copy_with_process_vm_readv(std::span<const std::byte>(&probe, 1), std::span<std::byte>(&probe, 1), isSupported);
+        g_hasProcessVmReadv.store(isSupported, std::memory_order_relaxed);
+    }
+
+    if (g_probePipeWrite.load(std::memory_order_relaxed) == -1) {
+        std::array<int, 2> pipeFds;
+
+        if (::pipe2(pipeFds.data(), O_CLOEXEC | O_NONBLOCK) == 0) {
+            g_probePipeRead.store(pipeFds[0], std::memory_order_relaxed);
+            g_probePipeWrite.store(pipeFds[1], std::memory_order_relaxed);
+        }
+    }
+
+    // Try the widest first; set_copy_kernel turns down anything the CPU can't do.
+    for (const auto kernel : { CopyKernel::Avx512, CopyKernel::Avx2, CopyKernel::Sse2, CopyKernel::Portable }) {
+        if (impl::set_copy_kernel(kernel)) {
+            break;
+        }
+    }
+}
+
+bool signalsafe::memory::impl::set_copy_kernel(const CopyKernel kernel) {
+    copy_function_t copyForward = nullptr;
+    copy_function_t copyBackward = nullptr;
+    copy_function_t copyStreaming = nullptr;
+
+    switch(kernel) {
+    case CopyKernel::Portable: {
+        copyForward = copy_forward_portable;
+        copyBackward = copy_backward_portable;
+        copyStreaming = copy_forward_portable;
+        break;
+    }
+#if defined(__x86_64__)
+    case CopyKernel::Sse2: {
+        copyForward = copy_forward_portable;
+        copyBackward = copy_backward_portable;
+        copyStreaming = copy_streaming_sse2;
+        break;
+    }
+    case CopyKernel::Avx2: {
+        if (! __builtin_cpu_supports("avx2")) {
+            return false;
+        }
+
+        copyForward = copy_forward_avx2;
+        copyBackward = copy_backward_avx2;
+        copyStreaming = copy_streaming_avx2;
+        break;
+    }
+    case CopyKernel::Avx512: {
+        if (! __builtin_cpu_supports("avx512f")) {
+            return false;
+        }
+
+        copyForward = copy_forward_avx512;
+        copyBackward = copy_backward_avx512;
+        copyStreaming = copy_streaming_avx512;
+        break;
+    }
+#else
+    default: return false;
+#endif
+    }
+
+    g_copyForward.store(copyForward, std::memory_order_relaxed);
+    g_copyBackward.store(copyBackward, std::memory_order_relaxed);
+    g_copyStreaming.store(copyStreaming, std::memory_order_relaxed);
+    g_copyKernel.store(kernel, std::memory_order_relaxed);
+
+    return true;
+}
+
+CopyKernel signalsafe::memory::impl::get_copy_kernel() {
+    return g_copyKernel.load(std::memory_order_relaxed);
+}
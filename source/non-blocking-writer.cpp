@@ -0,0 +1,146 @@
+#include "signalsafe/non-blocking-writer.hpp"
+#include "signalsafe/time.hpp"
+
+#include <utility>
+
+using signalsafe::FileHandle;
+using signalsafe::NonBlockingWriter;
+
+namespace {
+    int64_t get_monotonic_nanoseconds() {
+        const auto time = signalsafe::time::now(CLOCK_MONOTONIC);
+        return time.seconds * 1'000'000'000 + time.nanoseconds;
+    }
+}
+
+NonBlockingWriter::NonBlockingWriter(FileHandle file, const WouldBlockPolicy wouldBlockPolicy, const int64_t spinLimitNanoseconds)
+    : m_file(std::move(file))
+    , m_wouldBlockPolicy(wouldBlockPolicy)
+    , m_spinLimitNanoseconds(spinLimitNanoseconds) {
+}
+
+std::size_t NonBlockingWriter::write(std::span<const std::byte> source) {
+    int64_t spinDeadline = 0;
+    return write_internal(source, false, spinDeadline);
+}
+
+std::size_t NonBlockingWriter::write(std::span<const char> source) {
+    return write(std::as_bytes(source));
+}
+
+std::size_t NonBlockingWriter::write(std::span<const iovec> sources) {
+    std::size_t bytesWritten = 0;
+    int64_t spinDeadline = 0;
+
+    while(sources.size() > 0) {
+        auto newBytesWritten = m_file.write(sources);
+        bytesWritten += newBytesWritten;
+
+        if (newBytesWritten == 0) {
+            // The file would block before any more of it went out.
+            if (handle_would_block(bytesWritten != 0, spinDeadline)) {
+                continue;
+            }
+
+            return bytesWritten;
+        }
+
+        while(sources.size() > 0 && newBytesWritten >= sources.front().iov_len) {
+            newBytesWritten -= sources.front().iov_len;
+            sources = sources.last(sources.size() - 1);
+        }
+
+        if (newBytesWritten > 0) {
+            // As in FileHandle, the rest of a partially written source is written on its own.
+            const auto& partialSource = sources.front();
+            const auto remainingBytes = partialSource.iov_len - newBytesWritten;
+            const auto partialBytesWritten = write_internal(std::span<const std::byte>(
+                static_cast<const std::byte*>(partialSource.iov_base) + newBytesWritten,
+                remainingBytes
+            ), true, spinDeadline);
+
+            bytesWritten += partialBytesWritten;
+
+            if (partialBytesWritten != remainingBytes) {
+                // The file would block, and the policy says to give up (already counted).
+                return bytesWritten;
+            }
+
+            sources = sources.last(sources.size() - 1);
+        }
+    }
+
+    return bytesWritten;
+}
+
+std::size_t NonBlockingWriter::write_internal(std::span<const std::byte> source, const bool recordStarted, int64_t& spinDeadline) {
+    std::size_t bytesWritten = 0;
+
+    while(source.size() > 0) {
+        const auto newBytesWritten = m_file.write(source);
+        bytesWritten += newBytesWritten;
+        source = source.last(source.size() - newBytesWritten);
+
+        if (source.size() > 0 && ! handle_would_block(recordStarted || bytesWritten != 0, spinDeadline)) {
+            break;
+        }
+    }
+
+    return bytesWritten;
+}
+
+NonBlockingWriter::WouldBlockPolicy NonBlockingWriter::get_would_block_policy() const {
+    return m_wouldBlockPolicy;
+}
+
+std::size_t NonBlockingWriter::get_dropped_write_count() const {
+    return m_droppedWriteCount.load(std::memory_order_relaxed);
+}
+
+std::size_t NonBlockingWriter::get_short_write_count() const {
+    return m_shortWriteCount.load(std::memory_order_relaxed);
+}
+
+FileHandle& NonBlockingWriter::get_file() {
+    return m_file;
+}
+
+bool NonBlockingWriter::handle_would_block(const bool recordStarted, int64_t& spinDeadline) {
+    const auto keep_spinning = [&]() {
+        const auto now = get_monotonic_nanoseconds();
+
+        if (spinDeadline == 0) {
+            spinDeadline = now + m_spinLimitNanoseconds;
+        }
+
+        return now < spinDeadline;
+    };
+
+    switch(m_wouldBlockPolicy) {
+    case WouldBlockPolicy::Wait: return true;
+    case WouldBlockPolicy::Drop: {
+        // Once part of a record is out, finishing it is better than leaving it torn; but not at any cost,
+        // lest a stalled reader leave a handler spinning forever.
+        if (recordStarted && keep_spinning()) {
+            return true;
+        }
+
+        break;
+    }
+    case WouldBlockPolicy::WritePartial: break;
+    case WouldBlockPolicy::Spin: {
+        if (keep_spinning()) {
+            return true;
+        }
+
+        break;
+    }}
+
+    if (recordStarted) {
+        m_shortWriteCount.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_droppedWriteCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return false;
+}
@@ -0,0 +1,241 @@
+#include "signalsafe/per-cpu-buffer.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using signalsafe::impl::CpuAffinityGuard;
+using signalsafe::impl::RseqResult;
+
+// Declared weak so that we still link against C libraries that predate rseq support (glibc < 2.35).
+extern "C" {
+    extern const ptrdiff_t __rseq_offset __attribute__((weak));
+    extern const unsigned int __rseq_size __attribute__((weak));
+}
+
+namespace {
+    // Mirrors struct rseq from linux/rseq.h, which has changed shape between kernel versions.
+    struct alignas(32) RseqArea final {
+        uint32_t cpuIdStart = 0;
+        uint32_t cpuId = static_cast<uint32_t>(-1) /* RSEQ_CPU_ID_UNINITIALIZED */;
+        uint64_t rseqCs = 0;
+        uint32_t flags = 0;
+    };
+
+    // The kernel checks for this immediately before any abort handler,
+    // and the C library registers with it too, so it has to match theirs.
+    constexpr uint32_t rseqSignature = 0x53053053;
+
+    enum class RegistrationState : int {
+        Unregistered,
+        Registered,
+        Failed,
+        Disabled
+    };
+
+    // initial-exec so that touching these from a signal handler can never allocate.
+    thread_local RseqArea t_rseqArea __attribute__((tls_model("initial-exec")));
+    thread_local RegistrationState t_registrationState __attribute__((tls_model("initial-exec"))) = RegistrationState::Unregistered;
+    thread_local pid_t t_threadId __attribute__((tls_model("initial-exec"))) = 0;
+
+    [[maybe_unused]] bool is_registered_by_c_library() {
+        return &__rseq_size != nullptr && __rseq_size != 0;
+    }
+
+    RseqArea* get_rseq_area() {
+#if defined(__x86_64__) && defined(SYS_rseq)
+        if (t_registrationState == RegistrationState::Disabled) {
+            return nullptr;
+        }
+
+        if (is_registered_by_c_library()) {
+            // The C library keeps the thread pointer at offset 0 of the thread control block.
+            std::byte* threadPointer;
+            __asm__ ("movq %%fs:0, %0" : "=r"(threadPointer));
+
+            return reinterpret_cast<RseqArea*>(threadPointer + __rseq_offset);
+        }
+
+        if (t_registrationState == RegistrationState::Unregistered) {
+            const auto result = ::syscall(SYS_rseq, &t_rseqArea, sizeof(t_rseqArea), 0, rseqSignature);
+
+            // EBUSY means a handler that interrupted us already registered this thread.
+            t_registrationState = (result == 0 || errno == EBUSY) ? RegistrationState::Registered : RegistrationState::Failed;
+        }
+
+        return t_registrationState == RegistrationState::Registered ? &t_rseqArea : nullptr;
+#else
+        return nullptr;
+#endif
+    }
+
+#if defined(__x86_64__)
+    // Copies source to target and then stores newUsed to used,
+    // but only if the thread is on the CPU provided and used is still what was expected.
+    //
+    // Everything between labels 1 and 2 is restarted at label 4 by the kernel if the thread is preempted,
+    // migrated or signalled, so the final store to used either happens on the right CPU with nothing
+    // interleaved, or doesn't happen at all.
+    RseqResult rseq_compare_copy_store(
+        RseqArea& rseqArea,
+        const int cpu,
+        uint64_t& used,
+        const uint64_t expectedUsed,
+        std::byte* target,
+        const std::byte* source,
+        std::size_t length,
+        const uint64_t newUsed) {
+
+        static_assert(offsetof(RseqArea, cpuId) == 4);
+        static_assert(offsetof(RseqArea, rseqCs) == 8);
+
+        uint64_t result64;
+
+        __asm__ __volatile__ (
+            ".pushsection __rseq_cs, \"aw\"\n\t"
+            ".balign 32\n\t"
+            "3:\n\t"
+            ".long 0x0, 0x0\n\t"
+            ".quad 1f, (2f - 1f), 4f\n\t"
+            ".popsection\n\t"
+            ".pushsection __rseq_cs_ptr_array, \"aw\"\n\t"
+            ".quad 3b\n\t"
+            ".popsection\n\t"
+
+            "leaq 3b(%%rip), %[result]\n\t"
+            "movq %q[result], 8(%[rseqArea])\n\t"
+            "1:\n\t"
+            "cmpl %[cpu], 4(%[rseqArea])\n\t"
+            "jnz 4f\n\t"
+            "cmpq %[expectedUsed], %[used]\n\t"
+            "jnz 6f\n\t"
+            "rep movsb\n\t"
+            "movq %[newUsed], %[used]\n\t"
+            "2:\n\t"
+            "movl %[committed], %k[result]\n\t"
+            "jmp 5f\n\t"
+
+            "6:\n\t"
+            "movl %[changed], %k[result]\n\t"
+            "jmp 5f\n\t"
+
+            ".pushsection __rseq_failure, \"ax\"\n\t"
+            // ud1 <signature>(%rip), %edi; never executed, it just makes the signature disassemble sensibly.
+            ".byte 0x0f, 0xb9, 0x3d\n\t"
+            ".long 0x53053053\n\t"
+            "4:\n\t"
+            "movl %[aborted], %k[result]\n\t"
+            "jmp 5f\n\t"
+            ".popsection\n\t"
+
+            "5:\n\t"
+            : [result] "=&r"(result64),
+              [used] "+m"(used),
+              "+D"(target),
+              "+S"(source),
+              "+c"(length)
+            : [rseqArea] "r"(&rseqArea),
+              [cpu] "r"(cpu),
+              [expectedUsed] "r"(expectedUsed),
+              [newUsed] "r"(newUsed),
+              [committed] "i"(static_cast<int>(RseqResult::Committed)),
+              [aborted] "i"(static_cast<int>(RseqResult::Aborted)),
+              [changed] "i"(static_cast<int>(RseqResult::Changed))
+            : "memory", "cc"
+        );
+
+        static_assert(rseqSignature == 0x53053053, "the signature is repeated in the assembly above");
+
+        return static_cast<RseqResult>(static_cast<int>(result64));
+    }
+#endif
+}
+
+int signalsafe::impl::rseq_get_cpu() {
+    const auto* const rseqArea = get_rseq_area();
+
+    if (rseqArea == nullptr) {
+        return -1;
+    }
+
+    // Negative values mean registration failed or hasn't happened.
+    const auto cpu = static_cast<int32_t>(std::atomic_ref<const uint32_t>(rseqArea->cpuId).load(std::memory_order_relaxed));
+    return cpu < 0 ? -1 : cpu;
+}
+
+// The parameters go unused where there's no rseq support.
+RseqResult signalsafe::impl::rseq_try_append(
+    [[maybe_unused]] const int cpu,
+    [[maybe_unused]] uint64_t& used,
+    [[maybe_unused]] const uint64_t expectedUsed,
+    [[maybe_unused]] std::byte* const target,
+    [[maybe_unused]] std::span<const std::byte> source) {
+
+#if defined(__x86_64__)
+    auto* const rseqArea = get_rseq_area();
+    assert(rseqArea != nullptr);
+
+    return rseq_compare_copy_store(*rseqArea, cpu, used, expectedUsed, target, source.data(), source.size(), expectedUsed + source.size());
+#else
+    // rseq_get_cpu never succeeds here, so nothing should be calling this.
+    assert(false);
+    return RseqResult::Aborted;
+#endif
+}
+
+RseqResult signalsafe::impl::rseq_try_reset([[maybe_unused]] const int cpu, [[maybe_unused]] uint64_t& used, [[maybe_unused]] const uint64_t expectedUsed) {
+#if defined(__x86_64__)
+    auto* const rseqArea = get_rseq_area();
+    assert(rseqArea != nullptr);
+
+    return rseq_compare_copy_store(*rseqArea, cpu, used, expectedUsed, nullptr, nullptr, 0, 0);
+#else
+    // rseq_get_cpu never succeeds here, so nothing should be calling this.
+    assert(false);
+    return RseqResult::Aborted;
+#endif
+}
+
+CpuAffinityGuard::CpuAffinityGuard() {
+    CPU_ZERO(&m_previous);
+    [[maybe_unused]] const auto result = ::sched_getaffinity(0, sizeof(m_previous), &m_previous);
+    assert(result == 0);
+}
+
+CpuAffinityGuard::~CpuAffinityGuard() {
+    if (m_changed) {
+        [[maybe_unused]] const auto result = ::sched_setaffinity(0, sizeof(m_previous), &m_previous);
+        assert(result == 0);
+    }
+}
+
+bool CpuAffinityGuard::pin_to(const int cpu) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+
+    if (::sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+        return false;
+    }
+
+    m_changed = true;
+    return true;
+}
+
+void signalsafe::impl::rseq_disable() {
+    t_registrationState = RegistrationState::Disabled;
+}
+
+pid_t signalsafe::impl::get_thread_id() {
+    if (t_threadId == 0) {
+        t_threadId = static_cast<pid_t>(::syscall(SYS_gettid));
+    }
+
+    return t_threadId;
+}
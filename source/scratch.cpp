@@ -0,0 +1,68 @@
+#include "signalsafe/scratch.hpp"
+
+#include <atomic>
+#include <cassert>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    // Both zero initialised, so they live in the static TLS block and need no lazy allocation or constructor.
+    thread_local std::byte* t_scratch __attribute__((tls_model("initial-exec"))) = nullptr;
+    thread_local std::size_t t_scratchSize __attribute__((tls_model("initial-exec"))) = 0;
+}
+
+bool signalsafe::memory::thread_attach(const std::size_t size) {
+    assert(size > 0);
+
+    if (t_scratch != nullptr) {
+        return false;
+    }
+
+    const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const auto mappingSize = (size + pageSize - 1) / pageSize * pageSize;
+
+    void* const mapping = ::mmap(
+        nullptr,
+        mappingSize,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE,
+        -1,
+        0
+    );
+
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    // A handler that interrupts this sees either no region, or all of it.
+    t_scratch = static_cast<std::byte*>(mapping);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    t_scratchSize = mappingSize;
+
+    return true;
+}
+
+void signalsafe::memory::thread_detach() {
+    if (t_scratch == nullptr) {
+        return;
+    }
+
+    const auto scratch = t_scratch;
+    const auto scratchSize = t_scratchSize;
+
+    t_scratchSize = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    t_scratch = nullptr;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    [[maybe_unused]] const auto unmapResult = ::munmap(scratch, scratchSize);
+    assert(unmapResult == 0);
+}
+
+std::span<std::byte> signalsafe::memory::get_thread_scratch() {
+    const auto scratchSize = t_scratchSize;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    return { t_scratch, scratchSize };
+}
@@ -0,0 +1,210 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/arena.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using signalsafe::memory::Arena;
+
+SCENARIO("signalsafe::memory::Arena") {
+    GIVEN("a default constructed arena") {
+        Arena arena;
+
+        WHEN("some bytes are allocated") {
+            const auto bytes = arena.allocate(1);
+
+            THEN("there's no room for them") {
+                REQUIRE(bytes.empty());
+            }
+        }
+    }
+
+    GIVEN("an arena created with more capacity than could ever be mapped") {
+        auto arena = Arena::create(std::numeric_limits<std::size_t>::max() / 2);
+
+        THEN("it's left empty") {
+            REQUIRE(arena.get_capacity() == 0);
+        }
+
+        WHEN("some bytes are allocated") {
+            const auto bytes = arena.allocate(1);
+
+            THEN("there's no room for them") {
+                REQUIRE(bytes.empty());
+            }
+        }
+    }
+
+    GIVEN("an arena created with a capacity that can't be rounded up to a whole page") {
+        auto arena = Arena::create(std::numeric_limits<std::size_t>::max());
+
+        THEN("it's left empty") {
+            REQUIRE(arena.get_capacity() == 0);
+        }
+    }
+
+    GIVEN("an arena created with a capacity of less than a page") {
+        auto arena = Arena::create(100);
+
+        THEN("the capacity is rounded up to a whole page") {
+            REQUIRE(arena.get_capacity() == static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)));
+        }
+
+        THEN("nothing has been used yet") {
+            REQUIRE(arena.get_used() == 0);
+        }
+
+        WHEN("some bytes are allocated with a given alignment, after a single byte") {
+            const auto first = arena.allocate(1, 1);
+            const auto second = arena.allocate(24, 16);
+
+            THEN("both allocations succeed") {
+                REQUIRE(first.size() == 1);
+                REQUIRE(second.size() == 24);
+            }
+
+            THEN("the second is aligned as asked, after the first") {
+                REQUIRE(reinterpret_cast<uintptr_t>(second.data()) % 16 == 0);
+                REQUIRE(second.data() > first.data());
+            }
+
+            THEN("the padding counts towards what's used") {
+                REQUIRE(arena.get_used() == 16 + 24);
+            }
+
+            THEN("the bytes can be written to") {
+                second[0] = std::byte{1};
+                second[23] = std::byte{2};
+                REQUIRE(second[0] == std::byte{1});
+                REQUIRE(second[23] == std::byte{2});
+            }
+
+            AND_WHEN("it's reset") {
+                arena.reset();
+
+                THEN("nothing is used") {
+                    REQUIRE(arena.get_used() == 0);
+                }
+            }
+        }
+
+        WHEN("more bytes are allocated than it holds") {
+            const auto bytes = arena.allocate(arena.get_capacity() + 1);
+
+            THEN("the allocation fails, and uses nothing") {
+                REQUIRE(bytes.empty());
+                REQUIRE(arena.get_used() == 0);
+            }
+        }
+
+        WHEN("exactly as many bytes are allocated as it holds") {
+            const auto bytes = arena.allocate(arena.get_capacity());
+
+            THEN("the allocation succeeds") {
+                REQUIRE(bytes.size() == arena.get_capacity());
+            }
+
+            AND_WHEN("another byte is allocated") {
+                const auto more = arena.allocate(1);
+
+                THEN("there's no room for it") {
+                    REQUIRE(more.empty());
+                }
+            }
+        }
+
+        WHEN("an array of objects is allocated") {
+            const auto objects = arena.allocate<uint64_t>(10);
+
+            THEN("it's the size asked for, and suitably aligned") {
+                REQUIRE(objects.size() == 10);
+                REQUIRE(reinterpret_cast<uintptr_t>(objects.data()) % alignof(uint64_t) == 0);
+            }
+        }
+
+        WHEN("some bytes are allocated inside a scope") {
+            arena.allocate(8);
+            const auto usedBefore = arena.get_used();
+
+            {
+                Arena::Scope scope(arena);
+                arena.allocate(100);
+                REQUIRE(arena.get_used() > usedBefore);
+            }
+
+            THEN("they're released when it ends, but what came before isn't") {
+                REQUIRE(arena.get_used() == usedBefore);
+            }
+        }
+
+        WHEN("so many objects are allocated that their size in bytes would wrap around") {
+            const auto objects = arena.allocate<uint64_t>(std::numeric_limits<std::size_t>::max() / sizeof(uint64_t) + 2);
+
+            THEN("none are, and nothing is used") {
+                REQUIRE(objects.empty());
+                REQUIRE(arena.get_used() == 0);
+            }
+        }
+
+        WHEN("it's moved") {
+            arena.allocate(8);
+            const auto moved = std::move(arena);
+
+            THEN("the new arena has the memory and what was used of it") {
+                REQUIRE(moved.get_capacity() == static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)));
+                REQUIRE(moved.get_used() == 8);
+            }
+
+            THEN("the old one has nothing") {
+                REQUIRE(arena.get_capacity() == 0);
+                REQUIRE(arena.get_used() == 0);
+            }
+        }
+    }
+
+    GIVEN("an arena shared between several threads") {
+        constexpr std::size_t threadCount = 4;
+        constexpr std::size_t allocationsPerThread = 1000;
+
+        auto arena = Arena::create(threadCount * allocationsPerThread * 16);
+
+        WHEN("every thread allocates and fills blocks at the same time") {
+            std::vector<std::thread> threads;
+            std::array<std::vector<std::span<std::byte>>, threadCount> allocations;
+
+            for (std::size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+                threads.emplace_back([&arena, &allocations, threadIndex](){
+                    for (std::size_t i = 0; i < allocationsPerThread; ++i) {
+                        const auto bytes = arena.allocate(16, 16);
+                        std::fill(bytes.begin(), bytes.end(), static_cast<std::byte>(threadIndex));
+                        allocations[threadIndex].push_back(bytes);
+                    }
+                });
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            THEN("every allocation succeeds without overlapping any other") {
+                bool allCorrect = arena.get_used() == threadCount * allocationsPerThread * 16;
+
+                for (std::size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+                    for (const auto& bytes : allocations[threadIndex]) {
+                        allCorrect = allCorrect && bytes.size() == 16;
+
+                        for (const auto byte : bytes) {
+                            allCorrect = allCorrect && byte == static_cast<std::byte>(threadIndex);
+                        }
+                    }
+                }
+
+                REQUIRE(allCorrect);
+            }
+        }
+    }
+}
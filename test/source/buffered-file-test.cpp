@@ -0,0 +1,186 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/buffered-file.hpp>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+#include <unistd.h>
+
+using signalsafe::BufferedFile;
+using signalsafe::File;
+
+namespace {
+    std::size_t get_file_size(File& file) {
+        const auto originalOffset = file.seek(0, File::OffsetInterpretation::RelativeToCurrentPosition);
+        const auto size = file.seek(0, File::OffsetInterpretation::RelativeToEndOfFile);
+        file.seek(originalOffset, File::OffsetInterpretation::Absolute);
+        return static_cast<std::size_t>(size);
+    }
+}
+
+SCENARIO("signalsafe::BufferedFile") {
+    GIVEN("a buffered temporary file with an 8-byte staging buffer") {
+        BufferedFile<8> bufferedFile(File::create_and_open_temporary());
+
+        WHEN("fewer bytes than the staging buffer can hold are written") {
+            const std::array<std::byte, 3> data = { std::byte{1}, std::byte{2}, std::byte{3} };
+            const auto bytesWritten = bufferedFile.write(data);
+
+            THEN("all of the bytes are accepted") {
+                REQUIRE(bytesWritten == data.size());
+            }
+
+            THEN("they are held in the staging buffer") {
+                REQUIRE(bufferedFile.get_buffered_size() == data.size());
+            }
+
+            THEN("nothing has reached the file yet") {
+                REQUIRE(get_file_size(bufferedFile.get_file()) == 0);
+            }
+
+            AND_WHEN("flush is called") {
+                const auto bytesFlushed = bufferedFile.flush();
+
+                THEN("it reports the buffered bytes were written") {
+                    REQUIRE(bytesFlushed == data.size());
+                }
+
+                THEN("the staging buffer is empty") {
+                    REQUIRE(bufferedFile.get_buffered_size() == 0);
+                }
+
+                THEN("the bytes can be read back from the file") {
+                    auto& file = bufferedFile.get_file();
+                    file.seek(0, File::OffsetInterpretation::Absolute);
+
+                    std::array<std::byte, 3> readBack = { };
+                    REQUIRE(file.read(readBack) == readBack.size());
+                    REQUIRE(readBack == data);
+                }
+            }
+
+            AND_WHEN("more bytes are written than there is room left for") {
+                const std::array<std::byte, 6> moreData = {
+                    std::byte{4}, std::byte{5}, std::byte{6},
+                    std::byte{7}, std::byte{8}, std::byte{9}
+                };
+
+                bufferedFile.write(moreData);
+
+                THEN("the previously buffered bytes are flushed to the file") {
+                    REQUIRE(get_file_size(bufferedFile.get_file()) == data.size());
+                }
+
+                THEN("the new bytes are held in the staging buffer") {
+                    REQUIRE(bufferedFile.get_buffered_size() == moreData.size());
+                }
+            }
+        }
+
+        WHEN("a write at least as big as the staging buffer is made") {
+            const char data[] = "more than eight bytes";
+            const auto bytesWritten = bufferedFile.write(data);
+
+            THEN("all of the bytes are written") {
+                REQUIRE(bytesWritten == sizeof(data));
+            }
+
+            THEN("it bypasses the staging buffer") {
+                REQUIRE(bufferedFile.get_buffered_size() == 0);
+                REQUIRE(get_file_size(bufferedFile.get_file()) == sizeof(data));
+            }
+        }
+
+        WHEN("an integer is written") {
+            const uint32_t integer = 0xAABBCCDD;
+            const auto bytesWritten = bufferedFile.write(integer);
+
+            THEN("4 bytes are accepted") {
+                REQUIRE(bytesWritten == 4);
+                REQUIRE(bufferedFile.get_buffered_size() == 4);
+            }
+        }
+    }
+
+    GIVEN("a buffered pipe, made non-blocking, with only PIPE_BUF bytes of room left") {
+        std::array<int, 2> pipeFds = { -1, -1 };
+        REQUIRE(pipe(pipeFds.data()) == 0);
+
+        File readEnd = File::from_file_descriptor(pipeFds[0]);
+        File writeEnd = File::from_file_descriptor(pipeFds[1]);
+        REQUIRE(writeEnd.set_non_blocking(true));
+
+        const auto pipeCapacity = static_cast<std::size_t>(fcntl(pipeFds[1], F_GETPIPE_SZ));
+        const std::vector<std::byte> filler(pipeCapacity - PIPE_BUF);
+        REQUIRE(writeEnd.write(filler) == filler.size());
+
+        BufferedFile<PIPE_BUF * 2> bufferedFile(std::move(writeEnd));
+
+        // Anything up to PIPE_BUF goes into a pipe whole or not at all, so more than that is buffered.
+        std::vector<std::byte> data(PIPE_BUF + PIPE_BUF / 2);
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<std::byte>(i % 251);
+        }
+
+        REQUIRE(bufferedFile.write(data) == data.size());
+
+        WHEN("flush is called") {
+            const auto bytesFlushed = bufferedFile.flush();
+
+            THEN("only what fits is written") {
+                REQUIRE(bytesFlushed == PIPE_BUF);
+            }
+
+            THEN("the rest is kept in the staging buffer") {
+                REQUIRE(bufferedFile.get_buffered_size() == data.size() - PIPE_BUF);
+            }
+
+            AND_WHEN("the pipe is emptied and flush is called again") {
+                std::vector<std::byte> readBack(pipeCapacity);
+                REQUIRE(readEnd.read(readBack) == pipeCapacity);
+
+                const auto moreBytesFlushed = bufferedFile.flush();
+
+                THEN("the rest is written, carrying on from where it left off") {
+                    REQUIRE(moreBytesFlushed == data.size() - PIPE_BUF);
+                    REQUIRE(bufferedFile.get_buffered_size() == 0);
+
+                    readBack.resize(moreBytesFlushed);
+                    REQUIRE(readEnd.read(readBack) == moreBytesFlushed);
+                    REQUIRE(std::equal(readBack.begin(), readBack.end(), data.begin() + PIPE_BUF));
+                }
+            }
+
+            AND_WHEN("a write bigger than the staging buffer is made") {
+                const std::vector<std::byte> moreData(PIPE_BUF * 2, std::byte{1});
+                const auto bytesWritten = bufferedFile.write(moreData);
+
+                THEN("it doesn't jump ahead of what's still buffered, so only what fits is accepted") {
+                    REQUIRE(bytesWritten == PIPE_BUF * 2 - (data.size() - PIPE_BUF));
+                    REQUIRE(bufferedFile.get_buffered_size() == PIPE_BUF * 2);
+                }
+            }
+        }
+    }
+
+    GIVEN("a temporary file that won't be closed when its instance is destroyed") {
+        auto file = File::create_and_open_temporary();
+        const auto fd = file.get_file_descriptor();
+        file.set_destroy_action(File::DestroyAction::Nothing);
+
+        WHEN("bytes are written through a buffered file that is then destroyed") {
+            {
+                BufferedFile<16> bufferedFile(std::move(file));
+                bufferedFile.write(std::array<std::byte, 2>{ std::byte{42}, std::byte{43} });
+            }
+
+            THEN("the buffered bytes were flushed to the file") {
+                auto reopened = File::from_file_descriptor(fd);
+                REQUIRE(get_file_size(reopened) == 2);
+            }
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/checksum.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+using signalsafe::checksum::crc32c;
+
+namespace {
+    std::span<const std::byte> as_bytes(std::string_view string) {
+        return std::as_bytes(std::span<const char>(string.data(), string.size()));
+    }
+}
+
+SCENARIO("signalsafe::checksum") {
+    GIVEN("the standard CRC-32C check input") {
+        const auto input = as_bytes("123456789");
+
+        WHEN("its checksum is calculated") {
+            THEN("it matches the standard check value") {
+                REQUIRE(crc32c(input) == 0xE3069283);
+            }
+        }
+
+        WHEN("its checksum is calculated in pieces") {
+            THEN("it matches calculating it all at once") {
+                REQUIRE(crc32c(input.subspan(4), crc32c(input.first(4))) == 0xE3069283);
+            }
+        }
+    }
+
+    GIVEN("no bytes") {
+        THEN("the checksum is 0") {
+            REQUIRE(crc32c({ }) == 0);
+        }
+    }
+
+    GIVEN("32 bytes of zeros, from RFC 3720") {
+        const std::array<std::byte, 32> input = { };
+
+        THEN("the checksum matches the RFC") {
+            REQUIRE(crc32c(input) == 0x8A9136AA);
+        }
+    }
+}
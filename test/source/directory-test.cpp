@@ -0,0 +1,123 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/directory.hpp>
+
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+using signalsafe::Directory;
+using signalsafe::FileHandle;
+
+SCENARIO("signalsafe::Directory") {
+    GIVEN("an opened directory, whose path isn't null terminated") {
+        const std::string_view path = std::string_view("/tmp/ignored").substr(0, 4);
+        Directory directory = Directory::open_existing(path);
+        REQUIRE(directory.get_file_descriptor() != -1);
+
+        // Nor are the names; everything after the first 27 characters is ignored.
+        const std::string_view name = std::string_view("signalsafe-directory-test-aXXXX").substr(0, 27);
+        const std::string_view otherName = std::string_view("signalsafe-directory-test-bXXXX").substr(0, 27);
+        ::unlink("/tmp/signalsafe-directory-test-a");
+        ::unlink("/tmp/signalsafe-directory-test-b");
+
+        WHEN("a file is created in it and written to") {
+            FileHandle file = directory.create_and_open_at(name, FileHandle::Permissions::WriteOnly);
+            REQUIRE(file.get_file_descriptor() != -1);
+            REQUIRE(file.write(std::array<std::byte, 3>{ std::byte{1}, std::byte{2}, std::byte{3} }) == 3);
+
+            THEN("it can be opened again relative to the directory") {
+                FileHandle reopened = directory.open_existing_at(name, FileHandle::Permissions::ReadOnly);
+
+                std::array<std::byte, 3> readBack = { };
+                REQUIRE(reopened.read(readBack) == readBack.size());
+                REQUIRE(readBack[2] == std::byte{3});
+            }
+
+            THEN("it is visible at the full path") {
+                REQUIRE(::access("/tmp/signalsafe-directory-test-a", F_OK) == 0);
+            }
+
+            AND_WHEN("it is renamed") {
+                REQUIRE(directory.rename_at(name, otherName));
+
+                THEN("it is only visible under the new name") {
+                    REQUIRE(::access("/tmp/signalsafe-directory-test-a", F_OK) != 0);
+                    REQUIRE(::access("/tmp/signalsafe-directory-test-b", F_OK) == 0);
+                }
+
+                REQUIRE(directory.remove_at(otherName));
+            }
+
+            AND_WHEN("it is removed") {
+                REQUIRE(directory.remove_at(name));
+
+                THEN("it is no longer visible") {
+                    REQUIRE(::access("/tmp/signalsafe-directory-test-a", F_OK) != 0);
+                }
+
+                THEN("removing it again fails") {
+                    REQUIRE_FALSE(directory.remove_at(name));
+                }
+            }
+
+            ::unlink("/tmp/signalsafe-directory-test-a");
+        }
+
+        WHEN("a temporary file is created in it") {
+            FileHandle file = directory.create_and_open_temporary_at();
+            REQUIRE(file.get_file_descriptor() != -1);
+
+            AND_WHEN("it is linked into the directory") {
+                REQUIRE(directory.link_at(file, name));
+
+                THEN("it is visible at the full path") {
+                    REQUIRE(::access("/tmp/signalsafe-directory-test-a", F_OK) == 0);
+                }
+
+                THEN("it can't be linked to the same name again") {
+                    REQUIRE_FALSE(directory.link_at(file, name));
+                }
+
+                REQUIRE(directory.remove_at(name));
+            }
+        }
+
+        WHEN("a name is too long, but starts with the name of a file that exists") {
+            std::string longestName = "signalsafe-directory-test-";
+            longestName.resize(NAME_MAX, 'x');
+            const std::string tooLongName = longestName + "-and-more";
+
+            REQUIRE(directory.create_and_open_at(longestName, FileHandle::Permissions::WriteOnly).get_file_descriptor() != -1);
+
+            THEN("opening it fails") {
+                REQUIRE(directory.open_existing_at(tooLongName, FileHandle::Permissions::ReadOnly).get_file_descriptor() == -1);
+                REQUIRE(errno == ENAMETOOLONG);
+            }
+
+            THEN("removing or renaming it fails, and the file that exists is left alone") {
+                REQUIRE_FALSE(directory.remove_at(tooLongName));
+                REQUIRE(errno == ENAMETOOLONG);
+
+                REQUIRE_FALSE(directory.rename_at(tooLongName, name));
+                REQUIRE(errno == ENAMETOOLONG);
+
+                REQUIRE(directory.remove_at(longestName));
+            }
+
+            directory.remove_at(longestName);
+        }
+
+        WHEN("it is closed") {
+            THEN("it succeeds the first time only") {
+                REQUIRE(directory.close());
+                REQUIRE(directory.get_file_descriptor() == -1);
+                REQUIRE_FALSE(directory.close());
+            }
+        }
+    }
+}
@@ -0,0 +1,176 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/encoding.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using signalsafe::time::TimeSpecification;
+
+namespace encoding = signalsafe::encoding;
+
+SCENARIO("signalsafe::encoding") {
+    GIVEN("some signed values") {
+        THEN("zigzag keeps small magnitudes small") {
+            REQUIRE(encoding::zigzag_encode(0) == 0);
+            REQUIRE(encoding::zigzag_encode(-1) == 1);
+            REQUIRE(encoding::zigzag_encode(1) == 2);
+            REQUIRE(encoding::zigzag_encode(-2) == 3);
+        }
+
+        THEN("zigzag round trips the extremes") {
+            REQUIRE(encoding::zigzag_decode(encoding::zigzag_encode(std::numeric_limits<int64_t>::min())) == std::numeric_limits<int64_t>::min());
+            REQUIRE(encoding::zigzag_decode(encoding::zigzag_encode(std::numeric_limits<int64_t>::max())) == std::numeric_limits<int64_t>::max());
+        }
+    }
+
+    GIVEN("a range of unsigned values") {
+        const std::array<uint64_t, 7> values = { 0, 1, 127, 128, 300, uint64_t{1} << 56, std::numeric_limits<uint64_t>::max() };
+        const std::array<std::size_t, 7> sizes = { 1, 1, 1, 2, 2, 9, 10 };
+
+        WHEN("each is encoded and decoded") {
+            THEN("it round trips, taking up as few bytes as expected") {
+                for (std::size_t index = 0; index < values.size(); ++index) {
+                    std::array<std::byte, encoding::maxVarintSize> buffer = { };
+                    REQUIRE(encoding::encode_varint(buffer, values[index]) == sizes[index]);
+
+                    uint64_t decoded = 0;
+                    REQUIRE(encoding::decode_varint(buffer, decoded) == sizes[index]);
+                    REQUIRE(decoded == values[index]);
+                }
+            }
+        }
+
+        WHEN("one is encoded into a buffer that's too small") {
+            std::array<std::byte, 1> buffer = { };
+
+            THEN("nothing is written") {
+                REQUIRE(encoding::encode_varint(buffer, 128) == 0);
+            }
+        }
+
+        WHEN("one is decoded from a buffer that ends part way through") {
+            std::array<std::byte, encoding::maxVarintSize> buffer = { };
+            encoding::encode_varint(buffer, 300);
+
+            THEN("nothing is read") {
+                uint64_t decoded = 0;
+                REQUIRE(encoding::decode_varint(std::span<const std::byte>(buffer).first(1), decoded) == 0);
+            }
+        }
+
+        WHEN("they are all encoded one after the other, along with lots of small values, and decoded in bulk") {
+            std::vector<uint64_t> expected;
+            for (uint64_t value = 0; value < 100; ++value) {
+                expected.push_back(value % 3 == 0 ? values[value % values.size()] : value);
+            }
+
+            std::vector<std::byte> encoded(expected.size() * encoding::maxVarintSize);
+            std::size_t encodedSize = 0;
+            for (const auto value : expected) {
+                encodedSize += encoding::encode_varint(std::span<std::byte>(encoded).subspan(encodedSize), value);
+            }
+
+            std::vector<uint64_t> decoded(expected.size() + 10);
+            std::size_t bytesConsumed = 0;
+            const auto valuesRead = encoding::decode_varints(std::span<const std::byte>(encoded).first(encodedSize), decoded, bytesConsumed);
+
+            THEN("every value is read back") {
+                REQUIRE(valuesRead == expected.size());
+                REQUIRE(bytesConsumed == encodedSize);
+
+                decoded.resize(valuesRead);
+                REQUIRE(decoded == expected);
+            }
+        }
+    }
+
+    GIVEN("a stream of regularly spaced times, with some jitter") {
+        std::vector<TimeSpecification> times;
+        for (int64_t index = 0; index < 1000; ++index) {
+            const auto nanoseconds = int64_t{1'700'000'000'999'000'000} + index * 10'000 + (index % 7) * 13;
+            times.push_back({ nanoseconds / 1'000'000'000, nanoseconds % 1'000'000'000 });
+        }
+
+        WHEN("they are encoded") {
+            encoding::TimeEncoder encoder;
+            std::vector<std::byte> encoded(times.size() * encoding::maxVarintSize);
+            std::size_t encodedSize = 0;
+
+            for (const auto& time : times) {
+                const auto bytesWritten = encoder.encode(std::span<std::byte>(encoded).subspan(encodedSize), time);
+                REQUIRE(bytesWritten != 0);
+                encodedSize += bytesWritten;
+            }
+
+            THEN("they take up a fraction of the space") {
+                REQUIRE(encodedSize < times.size() * sizeof(TimeSpecification) / 5);
+            }
+
+            AND_WHEN("they are decoded one at a time") {
+                encoding::TimeDecoder decoder;
+                std::size_t bytesConsumed = 0;
+                bool allMatch = true;
+
+                for (const auto& time : times) {
+                    TimeSpecification decoded;
+                    bytesConsumed += decoder.decode(std::span<const std::byte>(encoded).subspan(bytesConsumed), decoded);
+                    allMatch = allMatch && decoded.seconds == time.seconds && decoded.nanoseconds == time.nanoseconds;
+                }
+
+                THEN("they match the originals") {
+                    REQUIRE(allMatch);
+                    REQUIRE(bytesConsumed == encodedSize);
+                }
+            }
+
+            AND_WHEN("they are decoded in bulk") {
+                encoding::TimeDecoder decoder;
+                std::vector<TimeSpecification> decoded(times.size());
+                std::size_t bytesConsumed = 0;
+
+                const auto timesRead = decoder.decode(std::span<const std::byte>(encoded).first(encodedSize), decoded, bytesConsumed);
+
+                THEN("they match the originals") {
+                    REQUIRE(timesRead == times.size());
+                    REQUIRE(bytesConsumed == encodedSize);
+
+                    bool allMatch = true;
+                    for (std::size_t index = 0; index < times.size(); ++index) {
+                        allMatch = allMatch && decoded[index].seconds == times[index].seconds
+                                            && decoded[index].nanoseconds == times[index].nanoseconds;
+                    }
+
+                    REQUIRE(allMatch);
+                }
+            }
+        }
+    }
+
+    GIVEN("an encoder with too little room for the next time") {
+        encoding::TimeEncoder encoder;
+        std::array<std::byte, 1> buffer = { };
+
+        WHEN("a time is encoded") {
+            THEN("nothing is written") {
+                REQUIRE(encoder.encode(buffer, { 100, 0 }) == 0);
+            }
+
+            AND_WHEN("it is encoded again with enough room") {
+                std::array<std::byte, encoding::maxVarintSize> biggerBuffer = { };
+                const auto bytesWritten = encoder.encode(biggerBuffer, { 100, 0 });
+
+                THEN("the stream carries on as if the first attempt never happened") {
+                    encoding::TimeDecoder decoder;
+                    TimeSpecification decoded;
+
+                    REQUIRE(decoder.decode(std::span<const std::byte>(biggerBuffer).first(bytesWritten), decoded) == bytesWritten);
+                    REQUIRE(decoded.seconds == 100);
+                    REQUIRE(decoded.nanoseconds == 0);
+                }
+            }
+        }
+    }
+}
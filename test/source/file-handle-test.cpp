@@ -0,0 +1,85 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/file.hpp>
+#include <signalsafe/file-handle.hpp>
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <type_traits>
+
+using signalsafe::File;
+using signalsafe::FileHandle;
+
+SCENARIO("signalsafe::FileHandle") {
+    GIVEN("the size of a file handle") {
+        // Just the descriptor and the destroy action, with nothing that would stop it being moved with memcpy.
+        static_assert(sizeof(FileHandle) <= 2 * sizeof(int));
+        static_assert(std::is_standard_layout_v<FileHandle>);
+        static_assert(std::is_final_v<FileHandle>);
+        static_assert(! std::has_virtual_destructor_v<FileHandle>);
+
+        THEN("it is much smaller than a file, which has to hold a path") {
+            REQUIRE(sizeof(File) > PATH_MAX);
+        }
+    }
+
+    GIVEN("a file and a file handle") {
+        // A file only hands out its handle by reference, so it can't lose its path to a move by accident.
+        static_assert(std::is_convertible_v<File&, FileHandle&>);
+        static_assert(! std::is_constructible_v<FileHandle, File&&>);
+        static_assert(! std::is_assignable_v<FileHandle&, File&&>);
+
+        THEN("a file can be used wherever a file handle is") {
+            File file = File::open_existing("/proc/self/maps", File::Permissions::ReadOnly);
+            FileHandle& fileHandle = file;
+            REQUIRE(fileHandle.get_file_descriptor() == file.get_file_descriptor());
+        }
+    }
+
+    GIVEN("a temporary file handle with some data written to it") {
+        FileHandle fileHandle = FileHandle::create_and_open_temporary();
+        const auto fd = fileHandle.get_file_descriptor();
+
+        REQUIRE(fd != -1);
+        REQUIRE(fileHandle.write(std::array<std::byte, 2>{ std::byte{1}, std::byte{2} }) == 2);
+
+        WHEN("it is moved") {
+            FileHandle movedTo = std::move(fileHandle);
+
+            THEN("the file descriptor goes with it") {
+                REQUIRE(movedTo.get_file_descriptor() == fd);
+                REQUIRE(fileHandle.get_file_descriptor() == -1);
+            }
+
+            THEN("the data can be read back through the new instance") {
+                std::array<std::byte, 2> readBack = { };
+                REQUIRE(movedTo.read_at(0, readBack) == 2);
+                REQUIRE(readBack[1] == std::byte{2});
+            }
+        }
+    }
+
+    GIVEN("a file that was opened with a path") {
+        File file = File::open_existing("/proc/self/maps", File::Permissions::ReadOnly);
+        const auto fd = file.get_file_descriptor();
+
+        WHEN("it is moved into another file") {
+            File movedTo = std::move(file);
+
+            THEN("the path goes with it") {
+                REQUIRE(movedTo.get_path() == "/proc/self/maps");
+                REQUIRE(file.get_path().empty());
+            }
+        }
+
+        WHEN("its handle is moved out explicitly") {
+            FileHandle fileHandle = std::move(file.get_handle());
+
+            THEN("the file descriptor goes with it, leaving the path behind") {
+                REQUIRE(fileHandle.get_file_descriptor() == fd);
+                REQUIRE(file.get_file_descriptor() == -1);
+                REQUIRE(file.get_path() == "/proc/self/maps");
+            }
+        }
+    }
+}
@@ -1,9 +1,16 @@
 #include "signalsafe-test.hpp"
 #include <signalsafe/file.hpp>
 
+#include <atomic>
+#include <csignal>
 #include <cstddef>
 #include <cstring>
 #include <filesystem>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/ioctl.h>
 
 using signalsafe::File;
 
@@ -64,6 +71,13 @@ namespace {
     bool is_fd_valid(int fd) {
         return fcntl(fd, F_GETFD) != -1;
     }
+
+    // Set once a blocked write has been interrupted and has returned to the caller.
+    std::atomic<bool> g_interrupted = false;
+
+    void interrupt(int) {
+        g_interrupted = true;
+    }
 }
 
 SCENARIO("signalsafe::File") {
@@ -542,5 +556,444 @@ SCENARIO("signalsafe::File") {
             }
         }
     }
+
+    GIVEN("a header, payload and trailer in separate buffers") {
+        const char header[] = "head";
+        const char payload[] = "payload";
+        const char trailer[] = "tail";
+
+        const std::array<iovec, 3> sources = {
+            iovec{ const_cast<char*>(header), sizeof(header) },
+            iovec{ const_cast<char*>(payload), sizeof(payload) },
+            iovec{ const_cast<char*>(trailer), sizeof(trailer) }
+        };
+
+        WHEN("create_and_open_temporary is called") {
+            File file = File::create_and_open_temporary();
+
+            AND_WHEN("they are written with a single vectored write") {
+                const auto bytesWritten = file.write(sources);
+
+                THEN("the total number of bytes is written") {
+                    REQUIRE(bytesWritten == sizeof(header) + sizeof(payload) + sizeof(trailer));
+                }
+
+                AND_WHEN("they are read back with a single vectored read into differently sized buffers") {
+                    file.seek(0, File::OffsetInterpretation::Absolute);
+
+                    std::array<char, 3> first = { };
+                    std::array<char, 11> second = { };
+                    std::array<char, 6> third = { };
+
+                    const std::array<iovec, 3> targets = {
+                        iovec{ first.data(), first.size() },
+                        iovec{ second.data(), second.size() },
+                        iovec{ third.data(), third.size() }
+                    };
+
+                    const auto bytesRead = file.read(targets);
+
+                    THEN("all of the bytes are read") {
+                        REQUIRE(bytesRead == bytesWritten);
+                    }
+
+                    THEN("the bytes are spread across the targets in order") {
+                        std::array<char, first.size() + second.size() + third.size()> joined = { };
+                        memcpy(joined.data(), first.data(), first.size());
+                        memcpy(joined.data() + first.size(), second.data(), second.size());
+                        memcpy(joined.data() + first.size() + second.size(), third.data(), third.size());
+
+                        REQUIRE(memcmp(joined.data(), header, sizeof(header)) == 0);
+                        REQUIRE(memcmp(joined.data() + sizeof(header), payload, sizeof(payload)) == 0);
+                        REQUIRE(memcmp(joined.data() + sizeof(header) + sizeof(payload), trailer, sizeof(trailer)) == 0);
+                    }
+                }
+
+                AND_WHEN("a vectored read asks for more bytes than the file contains") {
+                    file.seek(0, File::OffsetInterpretation::Absolute);
+
+                    std::array<char, 16> first = { };
+                    std::array<char, 16> second = { };
+
+                    const std::array<iovec, 2> targets = {
+                        iovec{ first.data(), first.size() },
+                        iovec{ second.data(), second.size() }
+                    };
+
+                    const auto bytesRead = file.read(targets);
+
+                    THEN("it stops at the end of the file") {
+                        REQUIRE(bytesRead == bytesWritten);
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("a header, payload and trailer that together are more than an empty pipe can hold") {
+        std::array<int, 2> pipeFds = { -1, -1 };
+        REQUIRE(pipe(pipeFds.data()) == 0);
+
+        File readEnd = File::from_file_descriptor(pipeFds[0]);
+        File writeEnd = File::from_file_descriptor(pipeFds[1]);
+
+        const auto pipeCapacity = static_cast<std::size_t>(fcntl(pipeFds[1], F_GETPIPE_SZ));
+
+        const char header[] = "head";
+        const char trailer[] = "tail";
+
+        std::vector<char> payload(pipeCapacity);
+        for (std::size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = static_cast<char>(i % 251);
+        }
+
+        const std::array<iovec, 3> sources = {
+            iovec{ const_cast<char*>(header), sizeof(header) },
+            iovec{ payload.data(), payload.size() },
+            iovec{ const_cast<char*>(trailer), sizeof(trailer) }
+        };
+
+        std::vector<char> expected;
+        expected.insert(expected.end(), header, header + sizeof(header));
+        expected.insert(expected.end(), payload.begin(), payload.end());
+        expected.insert(expected.end(), trailer, trailer + sizeof(trailer));
+
+        WHEN("they are written with a single vectored write, which a signal cuts short part way through the payload") {
+            g_interrupted = false;
+            const auto previous = std::signal(SIGUSR1, interrupt);
+            const auto writer = pthread_self();
+
+            std::vector<char> readBack(expected.size());
+            std::thread reader([&]() {
+                // The pipe only fills up once the writer is inside writev, so it's cut short there.
+                int bytesInPipe = 0;
+                while (ioctl(pipeFds[0], FIONREAD, &bytesInPipe) == 0 && static_cast<std::size_t>(bytesInPipe) < pipeCapacity) {
+                    std::this_thread::yield();
+                }
+
+                // Don't read anything until writev has returned, so that it can't finish the job itself.
+                pthread_kill(writer, SIGUSR1);
+                while (! g_interrupted) {
+                    std::this_thread::yield();
+                }
+
+                std::size_t bytesRead = 0;
+                while (bytesRead < readBack.size()) {
+                    const auto newBytesRead = readEnd.read(std::span<char>(readBack).subspan(bytesRead));
+                    if (newBytesRead == 0) {
+                        break;
+                    }
+
+                    bytesRead += newBytesRead;
+                }
+
+                readBack.resize(bytesRead);
+            });
+
+            const auto bytesWritten = writeEnd.write(sources);
+            writeEnd.close();
+            reader.join();
+
+            std::signal(SIGUSR1, previous);
+
+            THEN("the rest is still written, in order") {
+                REQUIRE(bytesWritten == expected.size());
+                REQUIRE(readBack == expected);
+            }
+        }
+    }
+
+    GIVEN("two slots' worth of data") {
+        const std::array<std::byte, 4> firstSlot = { std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4} };
+        const std::array<std::byte, 4> secondSlot = { std::byte{5}, std::byte{6}, std::byte{7}, std::byte{8} };
+
+        WHEN("create_and_open_temporary is called") {
+            File file = File::create_and_open_temporary();
+
+            AND_WHEN("the second slot is written with write_at before the first") {
+                const auto secondBytesWritten = file.write_at(4, secondSlot);
+                const auto firstBytesWritten = file.write_at(0, firstSlot);
+
+                THEN("the expected number of bytes is written each time") {
+                    REQUIRE(secondBytesWritten == secondSlot.size());
+                    REQUIRE(firstBytesWritten == firstSlot.size());
+                }
+
+                THEN("the file offset is unchanged") {
+                    REQUIRE(file.seek(0, File::OffsetInterpretation::RelativeToCurrentPosition) == 0);
+                }
+
+                AND_WHEN("the second slot is read back with read_at") {
+                    std::array<std::byte, 4> readBack = { };
+                    const auto bytesRead = file.read_at(4, readBack);
+
+                    THEN("it matches what was written there") {
+                        REQUIRE(bytesRead == readBack.size());
+                        REQUIRE(readBack == secondSlot);
+                    }
+
+                    THEN("the file offset is unchanged") {
+                        REQUIRE(file.seek(0, File::OffsetInterpretation::RelativeToCurrentPosition) == 0);
+                    }
+                }
+
+                AND_WHEN("read_at is asked for more bytes than there are after the offset") {
+                    std::array<char, 8> readBack = { };
+                    const auto bytesRead = file.read_at(6, readBack);
+
+                    THEN("it stops at the end of the file") {
+                        REQUIRE(bytesRead == 2);
+                    }
+                }
+            }
+        }
+    }
+
+    WHEN("create_and_open_temporary is called") {
+        File file = File::create_and_open_temporary();
+
+        AND_WHEN("reserve is called") {
+            const auto reserved = file.reserve(4096);
+
+            THEN("it returns true") {
+                REQUIRE(reserved);
+            }
+
+            THEN("the file is extended to the reserved length") {
+                REQUIRE(file.seek(0, File::OffsetInterpretation::RelativeToEndOfFile) == 4096);
+            }
+
+            AND_WHEN("reserve is called with a smaller length") {
+                REQUIRE(file.reserve(100));
+
+                THEN("the file is not shrunk") {
+                    REQUIRE(file.seek(0, File::OffsetInterpretation::RelativeToEndOfFile) == 4096);
+                }
+            }
+
+            AND_WHEN("truncate is called with a smaller length") {
+                const auto truncated = file.truncate(100);
+
+                THEN("it returns true") {
+                    REQUIRE(truncated);
+                }
+
+                THEN("the file is shrunk") {
+                    REQUIRE(file.seek(0, File::OffsetInterpretation::RelativeToEndOfFile) == 100);
+                }
+            }
+        }
+
+        AND_WHEN("truncate is called with a larger length") {
+            REQUIRE(file.truncate(10));
+
+            THEN("the file is padded with zeros") {
+                std::array<std::byte, 10> readBack;
+                readBack.fill(std::byte{1});
+
+                REQUIRE(file.read_at(0, readBack) == readBack.size());
+                REQUIRE(readBack == std::array<std::byte, 10>{ });
+            }
+        }
+    }
+
+    GIVEN("the write end of an empty pipe, made non-blocking") {
+        std::array<int, 2> pipeFds = { -1, -1 };
+        REQUIRE(pipe(pipeFds.data()) == 0);
+
+        File readEnd = File::from_file_descriptor(pipeFds[0]);
+        File writeEnd = File::from_file_descriptor(pipeFds[1]);
+
+        REQUIRE(writeEnd.set_non_blocking(true));
+        REQUIRE(readEnd.set_non_blocking(true));
+
+        const auto pipeCapacity = static_cast<std::size_t>(fcntl(pipeFds[1], F_GETPIPE_SZ));
+        const std::vector<std::byte> tooMuch(pipeCapacity + 1);
+
+        WHEN("more is written than the pipe can hold") {
+            const auto bytesWritten = writeEnd.write(tooMuch);
+
+            THEN("it writes what fits and returns rather than waiting") {
+                REQUIRE(bytesWritten == pipeCapacity);
+            }
+
+            AND_WHEN("more is written") {
+                const char record[] = "record";
+
+                THEN("nothing is written") {
+                    REQUIRE(writeEnd.write(record) == 0);
+                }
+            }
+
+            AND_WHEN("a read is made for more than the pipe holds") {
+                std::vector<std::byte> target(pipeCapacity + 1);
+                const auto bytesRead = readEnd.read(target);
+
+                THEN("it returns what was there rather than waiting") {
+                    REQUIRE(bytesRead == pipeCapacity);
+                }
+            }
+        }
+    }
+
+    GIVEN("a temporary file with some data in it") {
+        File source = File::create_and_open_temporary();
+
+        std::array<std::byte, 10000> data;
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<std::byte>(i % 251);
+        }
+
+        REQUIRE(source.write(data) == data.size());
+
+        AND_GIVEN("another temporary file that already has something in it") {
+            File target = File::create_and_open_temporary();
+            REQUIRE(target.write(std::array<std::byte, 2>{ std::byte{7}, std::byte{7} }) == 2);
+
+            WHEN("transfer_to is called for part of the data") {
+                const auto bytesTransferred = source.transfer_to(target, 1000, 5000);
+
+                THEN("the number of bytes requested is transferred") {
+                    REQUIRE(bytesTransferred == 5000);
+                }
+
+                THEN("they are appended at the target's file offset") {
+                    REQUIRE(target.seek(0, File::OffsetInterpretation::RelativeToCurrentPosition) == 5002);
+
+                    std::array<std::byte, 5000> readBack = { };
+                    REQUIRE(target.read_at(2, readBack) == readBack.size());
+                    REQUIRE(memcmp(readBack.data(), data.data() + 1000, readBack.size()) == 0);
+                }
+
+                THEN("the source's file offset is unchanged") {
+                    REQUIRE(source.seek(0, File::OffsetInterpretation::RelativeToCurrentPosition) == static_cast<off_t>(data.size()));
+                }
+            }
+
+            WHEN("transfer_to is asked for more bytes than are left") {
+                const auto bytesTransferred = source.transfer_to(target, 9000, 5000);
+
+                THEN("it stops at the end of the file") {
+                    REQUIRE(bytesTransferred == 1000);
+                }
+            }
+        }
+
+        AND_GIVEN("a pipe, which copy_file_range can't write to") {
+            std::array<int, 2> pipeFds = { -1, -1 };
+            REQUIRE(pipe(pipeFds.data()) == 0);
+
+            File readEnd = File::from_file_descriptor(pipeFds[0]);
+            File writeEnd = File::from_file_descriptor(pipeFds[1]);
+
+            WHEN("transfer_to is called with the write end") {
+                const auto bytesTransferred = source.transfer_to(writeEnd, 0, 1000);
+
+                THEN("another mechanism is used, and everything is transferred") {
+                    REQUIRE(bytesTransferred == 1000);
+
+                    std::array<std::byte, 1000> readBack = { };
+                    REQUIRE(readEnd.read(readBack) == readBack.size());
+                    REQUIRE(memcmp(readBack.data(), data.data(), readBack.size()) == 0);
+                }
+            }
+
+            WHEN("transfer_to is called with the read end, which can't be written to") {
+                const auto bytesTransferred = source.transfer_to(readEnd, 0, 1000);
+
+                THEN("it fails, without anything being transferred") {
+                    REQUIRE(bytesTransferred == 0);
+                }
+            }
+        }
+    }
+
+    GIVEN("a file in /proc, which reports its size as 0") {
+        File source = File::open_existing("/proc/self/maps", File::Permissions::ReadOnly);
+
+        WHEN("it is transferred to a temporary file") {
+            File target = File::create_and_open_temporary();
+            const auto bytesTransferred = source.transfer_to(target, 0, 1024 * 1024);
+
+            THEN("its contents are still transferred") {
+                REQUIRE(bytesTransferred > 0);
+                REQUIRE(target.seek(0, File::OffsetInterpretation::RelativeToEndOfFile) == static_cast<off_t>(bytesTransferred));
+            }
+        }
+    }
+
+    GIVEN("a temporary file with some data written to it") {
+        File file = File::create_and_open_temporary();
+        REQUIRE(file.write(std::array<std::byte, 3>{ std::byte{1}, std::byte{2}, std::byte{3} }) == 3);
+
+        WHEN("it is synced with each mode") {
+            THEN("every mode succeeds") {
+                REQUIRE(file.sync(File::SyncMode::Full));
+                REQUIRE(file.sync(File::SyncMode::Data));
+                REQUIRE(file.sync(File::SyncMode::WriteBack));
+            }
+        }
+
+        WHEN("write-back is started for part of it") {
+            THEN("it succeeds") {
+                REQUIRE(file.start_write_back(0, 2));
+            }
+        }
+    }
+
+    GIVEN("one end of a pipe") {
+        std::array<int, 2> pipeFds = { -1, -1 };
+        REQUIRE(::pipe(pipeFds.data()) == 0);
+
+        File readEnd = File::from_file_descriptor(pipeFds[0]);
+        File writeEnd = File::from_file_descriptor(pipeFds[1]);
+
+        WHEN("it is synced") {
+            THEN("it fails, since pipes can't be synced") {
+                REQUIRE_FALSE(writeEnd.sync(File::SyncMode::Full));
+                REQUIRE_FALSE(writeEnd.sync(File::SyncMode::WriteBack));
+            }
+        }
+    }
+
+    GIVEN("a temporary file created in a directory other than the current one") {
+        File file = File::create_and_open_temporary("/tmp");
+        REQUIRE(file.get_file_descriptor() != -1);
+        REQUIRE(file.get_path().empty());
+
+        const std::array<char, 5> data = { 'h', 'e', 'l', 'l', 'o' };
+        REQUIRE(file.write(data) == data.size());
+
+        const std::string_view path = "/tmp/signalsafe-link-as-test";
+        ::unlink(path.data());
+
+        WHEN("link_as is called") {
+            const auto linked = file.link_as(path);
+
+            THEN("it succeeds") {
+                REQUIRE(linked);
+            }
+
+            THEN("the file's path is recorded") {
+                REQUIRE(file.get_path() == path);
+            }
+
+            THEN("the file appears at that path with everything written to it") {
+                File reopened = File::open_existing(path, File::Permissions::ReadOnly);
+
+                std::array<char, 5> readBack = { };
+                REQUIRE(reopened.read(readBack) == readBack.size());
+                REQUIRE(readBack == data);
+            }
+
+            AND_WHEN("link_as is called again with the same path") {
+                THEN("it fails, since the path is taken") {
+                    REQUIRE_FALSE(file.link_as(path));
+                }
+            }
+
+            REQUIRE(file.remove());
+        }
+    }
 }
 
@@ -0,0 +1,230 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/file.hpp>
+#include <signalsafe/lz4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using signalsafe::File;
+using signalsafe::FileHandle;
+
+namespace lz4 = signalsafe::lz4;
+
+namespace {
+    // Just enough of a decoder to check what's written, following the LZ4 block and frame format specifications.
+    bool decompress_block(std::span<const std::byte> source, std::vector<std::byte>& target) {
+        const auto read_length = [&](std::size_t length) {
+            if (length == 15) {
+                std::byte extra;
+                do {
+                    if (source.empty()) {
+                        return std::size_t{0};
+                    }
+
+                    extra = source[0];
+                    source = source.subspan(1);
+                    length += static_cast<std::size_t>(extra);
+                } while(extra == std::byte{255});
+            }
+
+            return length;
+        };
+
+        while(! source.empty()) {
+            const auto token = static_cast<std::size_t>(source[0]);
+            source = source.subspan(1);
+
+            const auto literalLength = read_length(token >> 4);
+            if (literalLength > source.size()) {
+                return false;
+            }
+
+            target.insert(target.end(), source.begin(), source.begin() + static_cast<std::ptrdiff_t>(literalLength));
+            source = source.subspan(literalLength);
+
+            if (source.empty()) {
+                return true;
+            }
+
+            if (source.size() < 2) {
+                return false;
+            }
+
+            const auto offset = static_cast<std::size_t>(source[0]) | (static_cast<std::size_t>(source[1]) << 8);
+            source = source.subspan(2);
+
+            const auto matchLength = read_length(token & 0xF) + 4;
+            if (offset == 0 || offset > target.size()) {
+                return false;
+            }
+
+            for (std::size_t index = 0; index < matchLength; ++index) {
+                target.push_back(target[target.size() - offset]);
+            }
+        }
+
+        return true;
+    }
+
+    bool decompress_frame(std::span<const std::byte> source, std::vector<std::byte>& target) {
+        const auto read_32 = [&]() {
+            uint32_t value = 0;
+            for (std::size_t index = 0; index < 4; ++index) {
+                value |= static_cast<uint32_t>(source[index]) << (8 * index);
+            }
+
+            source = source.subspan(4);
+            return value;
+        };
+
+        if (source.size() < 7 || read_32() != 0x184D2204) {
+            return false;
+        }
+
+        source = source.subspan(3);
+
+        while(source.size() >= 4) {
+            const auto blockSize = read_32();
+
+            if (blockSize == 0) {
+                return source.empty();
+            }
+
+            const auto size = blockSize & 0x7FFFFFFF;
+            if (size > source.size()) {
+                return false;
+            }
+
+            if (blockSize & 0x80000000) {
+                target.insert(target.end(), source.begin(), source.begin() + size);
+            } else if (! decompress_block(source.first(size), target)) {
+                return false;
+            }
+
+            source = source.subspan(size);
+        }
+
+        return false;
+    }
+
+    std::vector<std::byte> read_all(File& file) {
+        const auto size = file.seek(0, File::OffsetInterpretation::RelativeToEndOfFile);
+        std::vector<std::byte> bytes(static_cast<std::size_t>(size));
+        file.read_at(0, bytes);
+        return bytes;
+    }
+}
+
+SCENARIO("signalsafe::lz4") {
+    GIVEN("the frame header") {
+        std::array<std::byte, 7> header;
+
+        THEN("it matches what the reference implementation writes for these settings") {
+            REQUIRE(lz4::encode_frame_header(header) == 7);
+
+            const std::array<std::byte, 7> expected = {
+                std::byte{0x04}, std::byte{0x22}, std::byte{0x4D}, std::byte{0x18},
+                std::byte{0x60}, std::byte{0x40}, std::byte{0x82}
+            };
+
+            REQUIRE(header == expected);
+        }
+    }
+
+    GIVEN("some repetitive data, like a trace of the same stack frames over and over") {
+        std::vector<std::byte> data;
+        for (uint64_t index = 0; index < 20000; ++index) {
+            const uint64_t frame = 0x400000 + (index % 16) * 0x40;
+            for (std::size_t byte = 0; byte < sizeof(frame); ++byte) {
+                data.push_back(static_cast<std::byte>(frame >> (8 * byte)));
+            }
+        }
+
+        WHEN("a block of it is compressed") {
+            lz4::HashTable hashTable = { };
+            std::vector<std::byte> compressed(lz4::maxBlockSize);
+            const auto compressedSize = lz4::compress_block(std::span<const std::byte>(data).first(lz4::maxBlockSize), compressed, hashTable);
+
+            THEN("it gets much smaller") {
+                REQUIRE(compressedSize != 0);
+                REQUIRE(compressedSize < lz4::maxBlockSize / 50);
+            }
+
+            THEN("it decompresses back to the original") {
+                std::vector<std::byte> decompressed;
+                REQUIRE(decompress_block(std::span<const std::byte>(compressed).first(compressedSize), decompressed));
+                REQUIRE(decompressed.size() == lz4::maxBlockSize);
+                REQUIRE(std::equal(decompressed.begin(), decompressed.end(), data.begin()));
+            }
+
+            AND_WHEN("it is compressed into a buffer that's too small") {
+                std::array<std::byte, 16> tooSmall;
+
+                THEN("nothing is written") {
+                    REQUIRE(lz4::compress_block(std::span<const std::byte>(data).first(lz4::maxBlockSize), tooSmall, hashTable) == 0);
+                }
+            }
+        }
+
+        WHEN("it is all written through a frame writer, in uneven pieces") {
+            File file = File::create_and_open_temporary();
+
+            {
+                auto frameWriter = std::make_unique<lz4::FrameWriter>(FileHandle::from_file_descriptor(file.get_file_descriptor()));
+                frameWriter->get_file().set_destroy_action(File::DestroyAction::Nothing);
+
+                auto remaining = std::span<const std::byte>(data);
+                for (std::size_t pieceSize = 1; ! remaining.empty(); pieceSize = pieceSize * 3 + 1) {
+                    const auto piece = remaining.first(std::min(pieceSize, remaining.size()));
+                    REQUIRE(frameWriter->write(piece) == piece.size());
+                    remaining = remaining.subspan(piece.size());
+                }
+
+                REQUIRE(frameWriter->finish());
+            }
+
+            THEN("the frame is much smaller than the data") {
+                REQUIRE(read_all(file).size() < data.size() / 50);
+            }
+
+            THEN("the frame decompresses back to the original") {
+                std::vector<std::byte> decompressed;
+                REQUIRE(decompress_frame(read_all(file), decompressed));
+                REQUIRE(decompressed == data);
+            }
+        }
+    }
+
+    GIVEN("data that doesn't compress, and data too short to have matches") {
+        std::vector<std::byte> data;
+        uint32_t state = 12345;
+        for (std::size_t index = 0; index < 1000; ++index) {
+            state = state * 1103515245 + 12345;
+            data.push_back(static_cast<std::byte>(state >> 16));
+        }
+
+        WHEN("they are written through a frame writer, with a flush between them") {
+            File file = File::create_and_open_temporary();
+
+            {
+                auto frameWriter = std::make_unique<lz4::FrameWriter>(FileHandle::from_file_descriptor(file.get_file_descriptor()));
+                frameWriter->get_file().set_destroy_action(File::DestroyAction::Nothing);
+                REQUIRE(frameWriter->write(data) == data.size());
+                REQUIRE(frameWriter->flush());
+                REQUIRE(frameWriter->write(std::span<const char>("abc", 3)) == 3);
+
+                // Finished on destruction.
+            }
+
+            THEN("the frame decompresses back to the original") {
+                std::vector<std::byte> decompressed;
+                REQUIRE(decompress_frame(read_all(file), decompressed));
+                REQUIRE(decompressed.size() == data.size() + 3);
+                REQUIRE(std::equal(data.begin(), data.end(), decompressed.begin()));
+                REQUIRE(decompressed.back() == std::byte{'c'});
+            }
+        }
+    }
+}
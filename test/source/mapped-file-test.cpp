@@ -0,0 +1,129 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/file.hpp>
+#include <signalsafe/mapped-file.hpp>
+#include <signalsafe/memory.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+using signalsafe::File;
+using signalsafe::MappedFile;
+using signalsafe::memory::copy_no_overlap;
+
+SCENARIO("signalsafe::MappedFile") {
+    GIVEN("a default constructed mapped file") {
+        MappedFile mappedFile;
+
+        WHEN("get_bytes is called") {
+            const auto bytes = mappedFile.get_bytes();
+
+            THEN("it returns an empty span") {
+                REQUIRE(bytes.empty());
+            }
+        }
+
+        WHEN("sync is called") {
+            const auto result = mappedFile.sync(MappedFile::SyncMode::Synchronous);
+
+            THEN("it returns false") {
+                REQUIRE(! result);
+            }
+        }
+
+        WHEN("unmap is called") {
+            const auto result = mappedFile.unmap();
+
+            THEN("it returns false") {
+                REQUIRE(! result);
+            }
+        }
+    }
+
+    GIVEN("a temporary file that is 8 KiB long") {
+        File file = File::create_and_open_temporary();
+        REQUIRE(file.write_at(8191, std::array<std::byte, 1>{ }) == 1);
+
+        WHEN("a region that doesn't start on a page boundary is mapped") {
+            auto mappedFile = MappedFile::map(file, 100, 16, File::Permissions::ReadWrite);
+
+            THEN("the mapped bytes are the size asked for") {
+                REQUIRE(mappedFile.get_bytes().size() == 16);
+            }
+
+            AND_WHEN("some bytes are copied into it and it is synced") {
+                const std::array<std::byte, 4> data = { std::byte{9}, std::byte{8}, std::byte{7}, std::byte{6} };
+                copy_no_overlap(data, mappedFile.get_bytes());
+
+                const auto synced = mappedFile.sync(MappedFile::SyncMode::Synchronous);
+
+                THEN("it reports success") {
+                    REQUIRE(synced);
+                }
+
+                THEN("the bytes can be read back from the file at the mapped offset") {
+                    std::array<std::byte, 4> readBack = { };
+                    REQUIRE(file.read_at(100, readBack) == readBack.size());
+                    REQUIRE(readBack == data);
+                }
+            }
+
+            AND_WHEN("it is moved from") {
+                const auto bytes = mappedFile.get_bytes();
+                MappedFile newMappedFile(std::move(mappedFile));
+
+                THEN("the moved-to instance has the mapping") {
+                    REQUIRE(newMappedFile.get_bytes().data() == bytes.data());
+                    REQUIRE(newMappedFile.get_bytes().size() == bytes.size());
+                }
+
+                THEN("the moved-from instance has nothing mapped") {
+                    REQUIRE(mappedFile.get_bytes().empty());
+                }
+            }
+
+            AND_WHEN("unmap is called") {
+                const auto result = mappedFile.unmap();
+
+                THEN("it returns true") {
+                    REQUIRE(result);
+                }
+
+                THEN("there are no bytes mapped") {
+                    REQUIRE(mappedFile.get_bytes().empty());
+                }
+            }
+        }
+    }
+
+    GIVEN("a temporary file that is 8 KiB long, open for reading and writing") {
+        File file = File::create_and_open_temporary();
+        REQUIRE(file.write_at(8191, std::array<std::byte, 1>{ }) == 1);
+
+        WHEN("it is mapped with WriteOnly permissions") {
+            auto mappedFile = MappedFile::map(file, 0, 16, File::Permissions::WriteOnly);
+
+            THEN("the mapping succeeds, and can be written to") {
+                REQUIRE(mappedFile.get_bytes().size() == 16);
+                mappedFile.get_bytes()[0] = std::byte{5};
+
+                std::array<std::byte, 1> readBack = { };
+                REQUIRE(file.read_at(0, readBack) == 1);
+                REQUIRE(readBack[0] == std::byte{5});
+            }
+        }
+
+        AND_GIVEN("the same file, opened again for writing only") {
+            File writeOnlyFile = File::open_existing("/proc/self/fd/" + std::to_string(file.get_file_descriptor()), File::Permissions::WriteOnly);
+
+            WHEN("it is mapped with WriteOnly permissions") {
+                auto mappedFile = MappedFile::map(writeOnlyFile, 0, 16, File::Permissions::WriteOnly);
+
+                THEN("the mapping fails, leaving nothing mapped") {
+                    REQUIRE(mappedFile.get_bytes().empty());
+                    REQUIRE(! mappedFile.unmap());
+                }
+            }
+        }
+    }
+}
@@ -1,7 +1,15 @@
 #include "signalsafe-test.hpp"
 #include <signalsafe/memory.hpp>
 
+#include <algorithm>
 #include <array>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
 
 using signalsafe::memory::copy_no_overlap;
 using signalsafe::memory::copy_with_overlap;
@@ -203,3 +211,408 @@ SCENARIO("signalsafe::memory") {
     }
 }
 
+
+SCENARIO("signalsafe::memory copy kernels") {
+    using signalsafe::memory::impl::CopyKernel;
+
+    GIVEN("a pattern of bytes, long enough to cover both the small and bulk paths") {
+        std::array<std::byte, 1024> pattern;
+        for (std::size_t index = 0; index < pattern.size(); ++index) {
+            pattern[index] = static_cast<std::byte>(index * 7 + 3);
+        }
+
+        const auto kernels = { CopyKernel::Portable, CopyKernel::Sse2, CopyKernel::Avx2, CopyKernel::Avx512 };
+
+        WHEN("every size up to 300 is copied, to and from every alignment within 16 bytes, with every supported kernel, using copy_no_overlap") {
+            bool allCorrect = true;
+
+            for (const auto kernel : kernels) {
+                if (! signalsafe::memory::impl::set_copy_kernel(kernel)) {
+                    continue;
+                }
+
+                for (std::size_t size = 0; size <= 300; ++size) {
+                    for (std::size_t alignment = 0; alignment < 16; ++alignment) {
+                        std::array<std::byte, 512> target;
+                        target.fill(std::byte{0xEE});
+
+                        const auto targetOffset = 15 - alignment;
+                        const auto bytesCopied = copy_no_overlap(
+                            std::span<const std::byte>(pattern.data() + alignment, size),
+                            std::span<std::byte>(target.data() + targetOffset, size)
+                        );
+
+                        allCorrect = allCorrect && bytesCopied == size;
+
+                        for (std::size_t index = 0; index < target.size(); ++index) {
+                            const auto isCopied = index >= targetOffset && index < targetOffset + size;
+                            const auto expected = isCopied ? pattern[index - targetOffset + alignment] : std::byte{0xEE};
+                            allCorrect = allCorrect && target[index] == expected;
+                        }
+                    }
+                }
+            }
+
+            signalsafe::memory::initialise();
+
+            THEN("exactly the bytes asked for are copied, every time") {
+                REQUIRE(allCorrect);
+            }
+        }
+
+        WHEN("every size up to 300 is copied within the same buffer, shifted both ways, with every supported kernel, using copy_with_overlap") {
+            bool allCorrect = true;
+
+            for (const auto kernel : kernels) {
+                if (! signalsafe::memory::impl::set_copy_kernel(kernel)) {
+                    continue;
+                }
+
+                for (std::size_t size = 0; size <= 300; ++size) {
+                    for (const std::ptrdiff_t shift : { -130, -65, -64, -33, -16, -7, -1, 0, 1, 7, 16, 33, 64, 65, 130 }) {
+                        auto buffer = pattern;
+                        const std::ptrdiff_t sourceOffset = 256;
+
+                        copy_with_overlap(
+                            std::span<const std::byte>(buffer.data() + sourceOffset, size),
+                            std::span<std::byte>(buffer.data() + sourceOffset + shift, size)
+                        );
+
+                        for (std::size_t index = 0; index < buffer.size(); ++index) {
+                            const auto targetIndex = static_cast<std::ptrdiff_t>(index) - sourceOffset - shift;
+                            const auto isCopied = targetIndex >= 0 && targetIndex < static_cast<std::ptrdiff_t>(size);
+                            const auto expected = isCopied ? pattern[sourceOffset + targetIndex] : pattern[index];
+                            allCorrect = allCorrect && buffer[index] == expected;
+                        }
+                    }
+                }
+            }
+
+            signalsafe::memory::initialise();
+
+            THEN("the target ends up with what the source had beforehand, every time") {
+                REQUIRE(allCorrect);
+            }
+        }
+    }
+
+    GIVEN("a pattern of bytes big enough for copy_streaming to bypass the cache") {
+        using signalsafe::memory::streamingThreshold;
+
+        std::vector<std::byte> pattern(streamingThreshold + 256);
+        for (std::size_t index = 0; index < pattern.size(); ++index) {
+            pattern[index] = static_cast<std::byte>(index * 7 + 3);
+        }
+
+        WHEN("sizes either side of the threshold are copied, to targets at various alignments, with every supported kernel, using copy_streaming") {
+            bool allCorrect = true;
+
+            for (const auto kernel : { CopyKernel::Portable, CopyKernel::Sse2, CopyKernel::Avx2, CopyKernel::Avx512 }) {
+                if (! signalsafe::memory::impl::set_copy_kernel(kernel)) {
+                    continue;
+                }
+
+                for (const auto size : { std::size_t{0}, std::size_t{1}, std::size_t{100}, streamingThreshold - 1, streamingThreshold, streamingThreshold + 63, streamingThreshold + 65 }) {
+                    for (const std::size_t alignment : { 0, 1, 15, 32, 63 }) {
+                        std::vector<std::byte> target(pattern.size() + 128, std::byte{0xEE});
+
+                        const auto bytesCopied = signalsafe::memory::copy_streaming(
+                            std::span<const std::byte>(pattern.data() + 3, size),
+                            std::span<std::byte>(target.data() + alignment, size)
+                        );
+
+                        allCorrect = allCorrect && bytesCopied == size;
+
+                        for (std::size_t index = 0; index < target.size(); ++index) {
+                            const auto isCopied = index >= alignment && index < alignment + size;
+                            const auto expected = isCopied ? pattern[index - alignment + 3] : std::byte{0xEE};
+                            allCorrect = allCorrect && target[index] == expected;
+                        }
+                    }
+                }
+            }
+
+            signalsafe::memory::initialise();
+
+            THEN("exactly the bytes asked for are copied, every time") {
+                REQUIRE(allCorrect);
+            }
+        }
+
+        WHEN("the whole pattern is copied to a vector, without wrapping either in a span") {
+            std::vector<std::byte> target(pattern.size());
+            const auto bytesCopied = signalsafe::memory::copy_streaming(pattern, target);
+
+            THEN("all of it is copied") {
+                REQUIRE(bytesCopied == pattern.size());
+                REQUIRE(target == pattern);
+            }
+        }
+    }
+
+    GIVEN("initialise has been called") {
+        signalsafe::memory::initialise();
+
+        THEN("a kernel the CPU supports has been picked") {
+            REQUIRE(signalsafe::memory::impl::set_copy_kernel(signalsafe::memory::impl::get_copy_kernel()));
+        }
+    }
+}
+
+SCENARIO("signalsafe::memory::try_copy") {
+    using signalsafe::memory::try_copy;
+    using signalsafe::memory::impl::try_copy_with_pipe;
+
+    signalsafe::memory::initialise();
+
+    GIVEN("three pages of memory, where only the first two are readable") {
+        const auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+        void* const mapping = ::mmap(nullptr, pageSize * 3, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        REQUIRE(mapping != MAP_FAILED);
+        REQUIRE(::mprotect(static_cast<std::byte*>(mapping) + pageSize * 2, pageSize, PROT_NONE) == 0);
+
+        const auto pages = std::span<std::byte>(static_cast<std::byte*>(mapping), pageSize * 3);
+        for (std::size_t index = 0; index < pageSize * 2; ++index) {
+            pages[index] = static_cast<std::byte>(index * 7 + 3);
+        }
+
+        std::vector<std::byte> target(pageSize * 3, std::byte{0xEE});
+
+        using try_copy_t = std::size_t (*)(std::span<const std::byte>, std::span<std::byte>);
+        const std::array<std::pair<const char*, try_copy_t>, 2> copies = {{
+            { "try_copy", try_copy },
+            { "try_copy_with_pipe", try_copy_with_pipe }
+        }};
+
+        for (const auto& [name, copy] : copies) {
+            WHEN(std::string("a readable region is copied with ") + name) {
+                const auto bytesCopied = copy(pages.subspan(100, pageSize), target);
+
+                THEN("all of it is copied") {
+                    REQUIRE(bytesCopied == pageSize);
+                    REQUIRE(std::equal(target.begin(), target.begin() + pageSize, pages.begin() + 100));
+                    REQUIRE(target[pageSize] == std::byte{0xEE});
+                }
+            }
+
+            WHEN(std::string("a region that runs into the unreadable page is copied with ") + name) {
+                const auto bytesCopied = copy(pages.subspan(pageSize + 10), target);
+
+                THEN("only the readable part is copied") {
+                    REQUIRE(bytesCopied == pageSize - 10);
+                    REQUIRE(std::equal(target.begin(), target.begin() + bytesCopied, pages.begin() + pageSize + 10));
+                    REQUIRE(target[bytesCopied] == std::byte{0xEE});
+                }
+            }
+
+            WHEN(std::string("a region inside the unreadable page is copied with ") + name) {
+                const auto bytesCopied = copy(pages.subspan(pageSize * 2 + 1, 8), target);
+
+                THEN("nothing is copied") {
+                    REQUIRE(bytesCopied == 0);
+                    REQUIRE(target[0] == std::byte{0xEE});
+                }
+            }
+
+            WHEN(std::string("a null pointer is copied from with ") + name) {
+                const auto bytesCopied = copy(std::span<const std::byte>(static_cast<const std::byte*>(nullptr), 16), target);
+
+                THEN("nothing is copied") {
+                    REQUIRE(bytesCopied == 0);
+                }
+            }
+        }
+
+        ::munmap(mapping, pageSize * 3);
+    }
+}
+
+SCENARIO("signalsafe::memory fill, compare and find") {
+    using signalsafe::memory::compare;
+    using signalsafe::memory::fill;
+    using signalsafe::memory::find;
+    using signalsafe::memory::find_any;
+    using signalsafe::memory::find_sequence;
+    using signalsafe::memory::find_unbounded;
+
+    GIVEN("a buffer") {
+        std::array<std::byte, 300> buffer;
+        buffer.fill(std::byte{0xEE});
+
+        WHEN("every size up to 200 is filled, at every alignment within 16 bytes") {
+            bool allCorrect = true;
+
+            for (std::size_t size = 0; size <= 200; ++size) {
+                for (std::size_t alignment = 0; alignment < 16; ++alignment) {
+                    buffer.fill(std::byte{0xEE});
+
+                    const auto bytesFilled = fill(std::span<std::byte>(buffer.data() + alignment, size), std::byte{0x42});
+                    allCorrect = allCorrect && bytesFilled == size;
+
+                    for (std::size_t index = 0; index < buffer.size(); ++index) {
+                        const auto isFilled = index >= alignment && index < alignment + size;
+                        allCorrect = allCorrect && buffer[index] == (isFilled ? std::byte{0x42} : std::byte{0xEE});
+                    }
+                }
+            }
+
+            THEN("exactly the bytes asked for are set, every time") {
+                REQUIRE(allCorrect);
+            }
+        }
+
+        WHEN("a span of integers is filled") {
+            std::array<uint32_t, 5> integers = { };
+            const auto bytesFilled = fill(std::span<uint32_t>(integers), std::byte{0x01});
+
+            THEN("every byte of every integer is set") {
+                REQUIRE(bytesFilled == sizeof(integers));
+                for (const auto integer : integers) {
+                    REQUIRE(integer == 0x01010101);
+                }
+            }
+        }
+    }
+
+    GIVEN("some containers of chars") {
+        std::array<char, 4> buffer = { };
+        const std::string_view text = "a needle in a haystack";
+        const std::string needles = "yk";
+
+        THEN("they can be used without wrapping them in spans first") {
+            REQUIRE(fill(buffer, std::byte{'x'}) == buffer.size());
+            REQUIRE(buffer == std::array<char, 4>{ 'x', 'x', 'x', 'x' });
+
+            REQUIRE(compare(buffer, std::string_view("xxxx")) == 0);
+            REQUIRE(compare(buffer, std::string_view("xxxy")) < 0);
+
+            REQUIRE(find(text, 'h') == text.find('h'));
+            REQUIRE(find(text, 'z') == text.size());
+            REQUIRE(find_any(text, needles) == text.find_first_of(needles));
+            REQUIRE(find_sequence(text, std::string_view("in a")) == text.find("in a"));
+            REQUIRE(find_sequence(text, needles) == text.size());
+        }
+    }
+
+    GIVEN("two identical buffers") {
+        std::array<std::byte, 200> lhs;
+        for (std::size_t index = 0; index < lhs.size(); ++index) {
+            lhs[index] = static_cast<std::byte>(index * 7 + 3);
+        }
+
+        auto rhs = lhs;
+
+        WHEN("they're compared") {
+            THEN("they compare equal") {
+                REQUIRE(compare(std::span<const std::byte>(lhs), std::span<const std::byte>(rhs)) == 0);
+            }
+        }
+
+        WHEN("a single byte differs, at every position in turn") {
+            bool allCorrect = true;
+
+            for (std::size_t index = 0; index < rhs.size(); ++index) {
+                if (lhs[index] == std::byte{0xFF}) {
+                    continue;
+                }
+
+                auto greater = lhs;
+                greater[index] = static_cast<std::byte>(static_cast<uint8_t>(lhs[index]) + 1);
+
+                // Both ways round, with the difference near the top of the byte's range, to check it's compared as unsigned.
+                auto negative = lhs;
+                negative[index] = std::byte{0x80};
+                auto positive = lhs;
+                positive[index] = std::byte{0x7F};
+
+                allCorrect = allCorrect && compare(std::span<const std::byte>(lhs), std::span<const std::byte>(greater)) < 0;
+                allCorrect = allCorrect && compare(std::span<const std::byte>(greater), std::span<const std::byte>(lhs)) > 0;
+                allCorrect = allCorrect && compare(std::span<const std::byte>(negative), std::span<const std::byte>(positive)) > 0;
+            }
+
+            THEN("the one with the greater byte comes second, every time") {
+                REQUIRE(allCorrect);
+            }
+        }
+
+        WHEN("one is shorter") {
+            const auto shorter = std::span<const std::byte>(rhs).first(100);
+
+            THEN("it comes first") {
+                REQUIRE(compare(shorter, std::span<const std::byte>(lhs)) < 0);
+                REQUIRE(compare(std::span<const std::byte>(lhs), shorter) > 0);
+            }
+        }
+    }
+
+    GIVEN("some chars") {
+        const char text[] = "the quick brown fox jumps over the lazy dog, then the quick brown fox sleeps";
+        const auto haystack = std::span<const char>(text, sizeof(text) - 1);
+
+        THEN("find returns the index of the first occurrence, or the size if there isn't one") {
+            REQUIRE(find(haystack, 'q') == 4);
+            REQUIRE(find(haystack, ',') == 43);
+            REQUIRE(find(haystack, 's') == std::string_view(text).find('s'));
+            REQUIRE(find(haystack, 'Z') == haystack.size());
+            REQUIRE(find(std::span<const char>(), 'a') == 0);
+        }
+
+        THEN("find_unbounded finds the terminator") {
+            REQUIRE(find_unbounded(text, '\0') == sizeof(text) - 1);
+
+            for (std::size_t offset = 0; offset < haystack.size(); ++offset) {
+                REQUIRE(find_unbounded(text + offset, '\0') == sizeof(text) - 1 - offset);
+            }
+        }
+
+        THEN("find_any returns the index of the first occurrence of any of the needles") {
+            REQUIRE(find_any(haystack, std::span<const char>(",z", 2)) == 37);
+            REQUIRE(find_any(haystack, std::span<const char>("!?", 2)) == haystack.size());
+            REQUIRE(find_any(haystack, std::span<const char>("y", 1)) == 38);
+            REQUIRE(find_any(haystack, std::span<const char>()) == haystack.size());
+
+            // More needles than fit in registers.
+            REQUIRE(find_any(haystack, std::span<const char>("0123456789,", 11)) == 43);
+        }
+
+        THEN("find_sequence returns the index of the first occurrence of the whole needle") {
+            REQUIRE(find_sequence(haystack, std::span<const char>("the", 3)) == 0);
+            REQUIRE(find_sequence(haystack, std::span<const char>("fox s", 5)) == std::string_view(text).find("fox s"));
+            REQUIRE(find_sequence(haystack, std::span<const char>("fox sleeps", 10)) == haystack.size() - 10);
+            REQUIRE(find_sequence(haystack, std::span<const char>("fox jumped", 10)) == haystack.size());
+            REQUIRE(find_sequence(haystack, std::span<const char>()) == 0);
+            REQUIRE(find_sequence(haystack.first(3), std::span<const char>("the quick", 9)) == 3);
+        }
+    }
+
+    GIVEN("a long pattern of bytes, and needles taken from it at every position") {
+        std::array<std::byte, 300> haystack;
+        for (std::size_t index = 0; index < haystack.size(); ++index) {
+            haystack[index] = static_cast<std::byte>(index % 251);
+        }
+
+        WHEN("they're searched for") {
+            bool allCorrect = true;
+
+            for (std::size_t start = 0; start < haystack.size(); ++start) {
+                const auto haystackSpan = std::span<const std::byte>(haystack);
+
+                allCorrect = allCorrect && find(haystackSpan.subspan(0, start + 1), haystack[start]) == start % 251;
+
+                for (const std::size_t needleSize : { 2, 3, 17, 40 }) {
+                    if (start + needleSize <= haystack.size()) {
+                        const auto needle = haystackSpan.subspan(start, needleSize);
+                        const auto expected = std::string_view(reinterpret_cast<const char*>(haystack.data()), haystack.size())
+                                                .find(std::string_view(reinterpret_cast<const char*>(needle.data()), needle.size()));
+                        allCorrect = allCorrect && find_sequence(haystackSpan, needle) == expected;
+                    }
+                }
+            }
+
+            THEN("each is found where a reference search finds it") {
+                REQUIRE(allCorrect);
+            }
+        }
+    }
+}
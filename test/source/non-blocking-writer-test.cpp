@@ -0,0 +1,151 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/file-handle.hpp>
+#include <signalsafe/non-blocking-writer.hpp>
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using signalsafe::FileHandle;
+using signalsafe::NonBlockingWriter;
+
+SCENARIO("signalsafe::NonBlockingWriter") {
+    GIVEN("a default constructed non-blocking writer") {
+        NonBlockingWriter writer;
+
+        THEN("the would-block policy defaults to Wait") {
+            REQUIRE(writer.get_would_block_policy() == NonBlockingWriter::WouldBlockPolicy::Wait);
+        }
+
+        THEN("nothing has been counted") {
+            REQUIRE(writer.get_dropped_write_count() == 0);
+            REQUIRE(writer.get_short_write_count() == 0);
+        }
+    }
+
+    GIVEN("the write end of an empty pipe, made non-blocking") {
+        std::array<int, 2> pipeFds = { -1, -1 };
+        REQUIRE(pipe(pipeFds.data()) == 0);
+
+        FileHandle readEnd = FileHandle::from_file_descriptor(pipeFds[0]);
+        FileHandle writeEnd = FileHandle::from_file_descriptor(pipeFds[1]);
+
+        REQUIRE(writeEnd.set_non_blocking(true));
+
+        const auto pipeCapacity = static_cast<std::size_t>(fcntl(pipeFds[1], F_GETPIPE_SZ));
+        const std::vector<std::byte> tooMuch(pipeCapacity + 1);
+
+        WHEN("the policy is WritePartial and more is written than the pipe can hold") {
+            NonBlockingWriter writer(std::move(writeEnd), NonBlockingWriter::WouldBlockPolicy::WritePartial);
+            const auto bytesWritten = writer.write(tooMuch);
+
+            THEN("it writes what fits and returns") {
+                REQUIRE(bytesWritten == pipeCapacity);
+            }
+
+            THEN("it is counted as a short write") {
+                REQUIRE(writer.get_short_write_count() == 1);
+                REQUIRE(writer.get_dropped_write_count() == 0);
+            }
+        }
+
+        WHEN("the policy is Drop and the pipe is full") {
+            REQUIRE(writeEnd.write(tooMuch) == pipeCapacity);
+
+            NonBlockingWriter writer(std::move(writeEnd), NonBlockingWriter::WouldBlockPolicy::Drop);
+
+            AND_WHEN("a record is written") {
+                const char record[] = "record";
+                const auto bytesWritten = writer.write(record);
+
+                THEN("nothing is written") {
+                    REQUIRE(bytesWritten == 0);
+                }
+
+                THEN("it is counted as dropped") {
+                    REQUIRE(writer.get_dropped_write_count() == 1);
+                    REQUIRE(writer.get_short_write_count() == 0);
+                }
+            }
+
+            AND_WHEN("a record is written in pieces") {
+                const char first[] = "first";
+                const char second[] = "second";
+                const std::array<iovec, 2> sources = {
+                    iovec{ const_cast<char*>(first), sizeof(first) },
+                    iovec{ const_cast<char*>(second), sizeof(second) }
+                };
+
+                const auto bytesWritten = writer.write(std::span<const iovec>(sources));
+
+                THEN("nothing is written, and it is counted as dropped") {
+                    REQUIRE(bytesWritten == 0);
+                    REQUIRE(writer.get_dropped_write_count() == 1);
+                }
+            }
+        }
+
+        WHEN("the policy is Drop and the pipe only has room for part of a record") {
+            // Records no bigger than PIPE_BUF go into a pipe whole or not at all, so this one is bigger.
+            const std::vector<std::byte> record(PIPE_BUF * 2);
+
+            REQUIRE(writeEnd.write(std::span<const std::byte>(tooMuch).first(pipeCapacity - PIPE_BUF)) == pipeCapacity - PIPE_BUF);
+
+            NonBlockingWriter writer(std::move(writeEnd), NonBlockingWriter::WouldBlockPolicy::Drop, 1'000'000);
+
+            AND_WHEN("the record is written, and nothing reads from the pipe") {
+                const auto bytesWritten = writer.write(record);
+
+                THEN("it gives up part way through once the spin limit passes") {
+                    REQUIRE(bytesWritten == PIPE_BUF);
+                    REQUIRE(writer.get_short_write_count() == 1);
+                    REQUIRE(writer.get_dropped_write_count() == 0);
+                }
+            }
+        }
+
+        WHEN("the policy is Spin and the pipe is full") {
+            REQUIRE(writeEnd.write(tooMuch) == pipeCapacity);
+
+            NonBlockingWriter writer(std::move(writeEnd), NonBlockingWriter::WouldBlockPolicy::Spin, 1'000'000);
+
+            AND_WHEN("a record is written") {
+                const char record[] = "record";
+                const auto bytesWritten = writer.write(record);
+
+                THEN("it gives up once the spin limit passes") {
+                    REQUIRE(bytesWritten == 0);
+                    REQUIRE(writer.get_dropped_write_count() == 1);
+                }
+            }
+        }
+
+        WHEN("the policy is Wait and more is written than the pipe can hold, while another thread reads") {
+            NonBlockingWriter writer(std::move(writeEnd), NonBlockingWriter::WouldBlockPolicy::Wait);
+
+            std::vector<std::byte> readBack(tooMuch.size());
+            std::size_t bytesRead = 0;
+            std::thread reader([&]() {
+                while (bytesRead < readBack.size()) {
+                    bytesRead += readEnd.read(std::span<std::byte>(readBack).subspan(bytesRead));
+                }
+            });
+
+            const auto bytesWritten = writer.write(tooMuch);
+            reader.join();
+
+            THEN("it all gets written") {
+                REQUIRE(bytesWritten == tooMuch.size());
+                REQUIRE(bytesRead == tooMuch.size());
+                REQUIRE(writer.get_dropped_write_count() == 0);
+                REQUIRE(writer.get_short_write_count() == 0);
+            }
+        }
+    }
+}
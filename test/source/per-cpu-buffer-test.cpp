@@ -0,0 +1,168 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/file.hpp>
+#include <signalsafe/per-cpu-buffer.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using signalsafe::File;
+using signalsafe::PerCpuBuffer;
+
+SCENARIO("signalsafe::PerCpuBuffer") {
+    GIVEN("a per-CPU buffer with room for every CPU") {
+        static PerCpuBuffer<1024, 1024> buffer;
+
+        // It's static (to keep it off the stack), so get rid of anything left by previous sections.
+        {
+            File discarded = File::create_and_open_temporary();
+            buffer.flush(discarded);
+        }
+
+        WHEN("flush is called while it is empty") {
+            File file = File::create_and_open_temporary();
+            const auto bytesWritten = buffer.flush(file);
+
+            THEN("nothing is written") {
+                REQUIRE(bytesWritten == 0);
+            }
+        }
+
+        WHEN("two records are appended from this thread") {
+            const char first[] = "first";
+            const char second[] = "second";
+
+            REQUIRE(buffer.append(first));
+            REQUIRE(buffer.append(second));
+
+            AND_WHEN("it is flushed to a file") {
+                File file = File::create_and_open_temporary();
+                const auto bytesWritten = buffer.flush(file);
+
+                THEN("both records are written") {
+                    REQUIRE(bytesWritten == sizeof(first) + sizeof(second));
+                }
+
+                AND_WHEN("it is flushed again") {
+                    const auto bytesWrittenAgain = buffer.flush(file);
+
+                    THEN("nothing more is written") {
+                        REQUIRE(bytesWrittenAgain == 0);
+                    }
+                }
+            }
+        }
+
+        WHEN("a record too big to fit is appended") {
+            const std::array<std::byte, 1025> record = { };
+            const auto droppedCountBefore = buffer.get_dropped_count();
+
+            THEN("it is dropped") {
+                REQUIRE(! buffer.append(record));
+                REQUIRE(buffer.get_dropped_count() == droppedCountBefore + 1);
+            }
+        }
+
+        WHEN("several threads append records") {
+            constexpr std::size_t threadCount = 4;
+            constexpr std::size_t recordsPerThread = 20;
+
+            std::vector<std::thread> threads;
+            std::atomic<std::size_t> recordsAppended = 0;
+
+            for (std::size_t i = 0; i < threadCount; ++i) {
+                threads.emplace_back([&recordsAppended](){
+                    for (std::size_t j = 0; j < recordsPerThread; ++j) {
+                        if (buffer.append(std::array<std::byte, 4>{ std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4} })) {
+                            recordsAppended += 1;
+                        }
+                    }
+                });
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            THEN("none of them are dropped") {
+                REQUIRE(recordsAppended == threadCount * recordsPerThread);
+            }
+
+            AND_WHEN("it is flushed to a file") {
+                File file = File::create_and_open_temporary();
+                const auto bytesWritten = buffer.flush(file);
+
+                THEN("every record is written intact") {
+                    REQUIRE(bytesWritten == threadCount * recordsPerThread * 4);
+
+                    std::array<std::byte, threadCount * recordsPerThread * 4> readBack = { };
+                    REQUIRE(file.read_at(0, readBack) == readBack.size());
+
+                    for (std::size_t i = 0; i < readBack.size(); i += 4) {
+                        REQUIRE(readBack[i] == std::byte{1});
+                        REQUIRE(readBack[i + 3] == std::byte{4});
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN("a per-CPU buffer with fewer regions than threads that will use it") {
+        static PerCpuBuffer<64, 4> buffer;
+
+        {
+            File discarded = File::create_and_open_temporary();
+            buffer.flush(discarded);
+        }
+
+        WHEN("more short-lived threads than there are regions append a record each, without rseq") {
+            constexpr std::size_t threadCount = 32;
+
+            std::size_t recordsAppended = 0;
+            bool rseqDisabled = true;
+
+            for (std::size_t i = 0; i < threadCount; ++i) {
+                std::thread([&recordsAppended, &rseqDisabled, i](){
+                    signalsafe::impl::rseq_disable();
+                    rseqDisabled = rseqDisabled && signalsafe::impl::rseq_get_cpu() == -1;
+
+                    if (buffer.append(std::array<std::byte, 4>{ static_cast<std::byte>(i), std::byte{2}, std::byte{3}, std::byte{4} })) {
+                        recordsAppended += 1;
+                    }
+                }).join();
+            }
+
+            THEN("every thread falls back, and none of their records are dropped") {
+                REQUIRE(rseqDisabled);
+                REQUIRE(recordsAppended == threadCount);
+                REQUIRE(buffer.get_dropped_count() == 0);
+            }
+
+            AND_WHEN("it is flushed to a file") {
+                File file = File::create_and_open_temporary();
+                const auto bytesWritten = buffer.flush(file);
+
+                THEN("every record is written intact") {
+                    REQUIRE(bytesWritten == threadCount * 4);
+
+                    std::array<std::byte, threadCount * 4> readBack = { };
+                    REQUIRE(file.read_at(0, readBack) == readBack.size());
+
+                    std::array<bool, threadCount> seen = { };
+
+                    for (std::size_t i = 0; i < readBack.size(); i += 4) {
+                        seen[static_cast<std::size_t>(readBack[i])] = true;
+                        REQUIRE(readBack[i + 3] == std::byte{4});
+                    }
+
+                    for (const auto threadSeen : seen) {
+                        REQUIRE(threadSeen);
+                    }
+                }
+            }
+        }
+    }
+}
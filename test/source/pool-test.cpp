@@ -0,0 +1,149 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/pool.hpp>
+
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using signalsafe::memory::Pool;
+
+namespace {
+    struct Counted {
+        explicit Counted(int& liveCount, uint64_t value) : m_liveCount(liveCount), m_value(value) {
+            m_liveCount += 1;
+        }
+
+        ~Counted() {
+            m_liveCount -= 1;
+        }
+
+        int& m_liveCount;
+        uint64_t m_value;
+    };
+
+    Pool<std::array<uint64_t, 4>, 64> sharedPool;
+}
+
+SCENARIO("signalsafe::memory::Pool") {
+    GIVEN("a pool with room for 3 objects") {
+        int liveCount = 0;
+        Pool<Counted, 3> pool;
+
+        THEN("it reports its capacity") {
+            REQUIRE(pool.get_capacity() == 3);
+        }
+
+        WHEN("3 objects are created") {
+            auto* const first = pool.create(liveCount, 1);
+            auto* const second = pool.create(liveCount, 2);
+            auto* const third = pool.create(liveCount, 3);
+
+            THEN("they're all constructed, in different slots") {
+                REQUIRE(first != nullptr);
+                REQUIRE(second != nullptr);
+                REQUIRE(third != nullptr);
+                REQUIRE(first != second);
+                REQUIRE(second != third);
+                REQUIRE(liveCount == 3);
+                REQUIRE(first->m_value == 1);
+                REQUIRE(third->m_value == 3);
+            }
+
+            AND_WHEN("a 4th is created") {
+                auto* const fourth = pool.create(liveCount, 4);
+
+                THEN("there's no room for it") {
+                    REQUIRE(fourth == nullptr);
+                    REQUIRE(liveCount == 3);
+                }
+            }
+
+            AND_WHEN("one is destroyed and another created") {
+                pool.destroy(second);
+                REQUIRE(liveCount == 2);
+
+                auto* const replacement = pool.create(liveCount, 5);
+
+                THEN("it reuses the freed slot") {
+                    REQUIRE(replacement == second);
+                    REQUIRE(replacement->m_value == 5);
+                    REQUIRE(liveCount == 3);
+                }
+            }
+
+            pool.destroy(first);
+            pool.destroy(third);
+        }
+
+        WHEN("nullptr is destroyed") {
+            pool.destroy(nullptr);
+
+            THEN("nothing happens") {
+                REQUIRE(liveCount == 0);
+            }
+        }
+    }
+
+    GIVEN("a pool shared between several threads") {
+        constexpr uint64_t threadCount = 4;
+        constexpr uint64_t iterationsPerThread = 20000;
+
+        WHEN("every thread repeatedly creates objects, checks nobody else has them, then destroys them") {
+            std::vector<std::thread> threads;
+            std::array<bool, threadCount> allCorrect = { };
+
+            for (uint64_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+                threads.emplace_back([threadIndex, &allCorrect](){
+                    bool correct = true;
+
+                    for (uint64_t i = 0; i < iterationsPerThread; ++i) {
+                        std::array<std::array<uint64_t, 4>*, 4> objects = { };
+
+                        for (auto& object : objects) {
+                            while((object = sharedPool.create()) == nullptr);
+                            object->fill(threadIndex * iterationsPerThread + i);
+                        }
+
+                        for (const auto* const object : objects) {
+                            for (const auto value : *object) {
+                                correct = correct && value == threadIndex * iterationsPerThread + i;
+                            }
+                        }
+
+                        for (auto* const object : objects) {
+                            sharedPool.destroy(object);
+                        }
+                    }
+
+                    allCorrect[threadIndex] = correct;
+                });
+            }
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+
+            THEN("no object is ever handed out twice at once") {
+                for (const auto correct : allCorrect) {
+                    REQUIRE(correct);
+                }
+            }
+
+            THEN("every slot is free again afterwards") {
+                std::array<std::array<uint64_t, 4>*, 64> objects = { };
+
+                for (auto& object : objects) {
+                    object = sharedPool.create();
+                    REQUIRE(object != nullptr);
+                }
+
+                REQUIRE(sharedPool.create() == nullptr);
+
+                for (auto* const object : objects) {
+                    sharedPool.destroy(object);
+                }
+            }
+        }
+    }
+}
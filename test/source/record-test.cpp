@@ -0,0 +1,207 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/file.hpp>
+#include <signalsafe/mapped-file.hpp>
+#include <signalsafe/record.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using signalsafe::File;
+using signalsafe::MappedFile;
+
+namespace record = signalsafe::record;
+
+namespace {
+    struct Sample final {
+        static constexpr uint16_t recordType = 1;
+        static constexpr uint8_t recordVersion = 2;
+
+        uint64_t address = 0;
+        uint32_t threadID = 0;
+    };
+
+    struct Marker final {
+        static constexpr uint16_t recordType = 2;
+        static constexpr uint8_t recordVersion = 1;
+
+        std::array<char, 3> name = { };
+    };
+
+    static_assert(record::Recordable<Sample>);
+    static_assert(! record::Recordable<int>);
+}
+
+SCENARIO("signalsafe::record") {
+    GIVEN("the size of records") {
+        THEN("they are padded to the alignment") {
+            REQUIRE(record::get_record_size(0) == 8);
+            REQUIRE(record::get_record_size(1) == 16);
+            REQUIRE(record::get_record_size(8) == 16);
+            REQUIRE(record::get_record_size(9) == 24);
+        }
+
+        THEN("the biggest payload is the biggest length a header can hold") {
+            REQUIRE(record::maxPayloadSize == std::numeric_limits<uint32_t>::max());
+        }
+    }
+
+    GIVEN("a temporary file with some records written to it") {
+        File file = File::create_and_open_temporary();
+
+        REQUIRE(record::write(file, Sample{ 0x1234, 7 }) == record::get_record_size(sizeof(Sample)));
+        REQUIRE(record::write(file, Marker{ { 'a', 'b', 'c' } }) == record::get_record_size(sizeof(Marker)));
+        REQUIRE(record::write(file, Sample{ 0x5678, 8 }) == record::get_record_size(sizeof(Sample)));
+
+        const auto fileSize = file.seek(0, File::OffsetInterpretation::RelativeToCurrentPosition);
+        REQUIRE(fileSize == 24 + 16 + 24);
+
+        WHEN("the file is mapped and read") {
+            // Reserve some extra, so there are zeros after the last record.
+            REQUIRE(file.reserve(4096));
+
+            const auto mappedFile = MappedFile::map(file, 0, 4096, File::Permissions::ReadOnly);
+            const record::Reader reader(mappedFile.get_bytes());
+
+            std::vector<record::View> views;
+            for (const auto& view : reader) {
+                views.push_back(view);
+            }
+
+            THEN("every record is found, and nothing more") {
+                REQUIRE(views.size() == 3);
+            }
+
+            THEN("the records can be read in place as their types") {
+                REQUIRE(views[0].get_as<Sample>() != nullptr);
+                REQUIRE(views[0].get_as<Sample>()->address == 0x1234);
+                REQUIRE(views[0].get_as<Sample>()->threadID == 7);
+                REQUIRE(reinterpret_cast<const std::byte*>(views[0].get_as<Sample>()) == mappedFile.get_bytes().data() + sizeof(record::Header));
+
+                REQUIRE(views[1].get_as<Marker>() != nullptr);
+                REQUIRE(views[1].get_as<Marker>()->name[2] == 'c');
+                REQUIRE(views[1].get_header().length == sizeof(Marker));
+
+                REQUIRE(views[2].get_as<Sample>()->address == 0x5678);
+            }
+
+            THEN("records can't be read as the wrong type") {
+                REQUIRE(views[0].get_as<Marker>() == nullptr);
+                REQUIRE(views[1].get_as<Sample>() == nullptr);
+            }
+        }
+    }
+
+    GIVEN("a buffer with room for two samples") {
+        alignas(record::alignment) std::array<std::byte, 2 * record::get_record_size(sizeof(Sample))> buffer = { };
+
+        WHEN("three samples are encoded into it") {
+            auto target = std::span<std::byte>(buffer);
+
+            for (uint64_t address = 1; address <= 3; ++address) {
+                target = target.subspan(record::encode(target, Sample{ address, 0 }));
+            }
+
+            THEN("only the first two fit") {
+                REQUIRE(target.empty());
+                REQUIRE(record::encode(target, Sample{ }) == 0);
+            }
+
+            AND_WHEN("the buffer is read, with the end of the last record cut off") {
+                const record::Reader reader(std::span<const std::byte>(buffer).first(buffer.size() - 1));
+
+                std::size_t count = 0;
+                auto iterator = reader.begin();
+                for (; iterator != reader.end(); ++iterator) {
+                    count += 1;
+                }
+
+                THEN("only the complete record is read") {
+                    REQUIRE(count == 1);
+                    REQUIRE(iterator.get_remaining().empty());
+                }
+            }
+        }
+    }
+
+    GIVEN("a checksummed record with a flag that isn't known, followed by an ordinary checksummed record") {
+        constexpr auto recordSize = record::get_record_size(sizeof(Sample), record::Checksummed);
+        alignas(record::alignment) std::array<std::byte, 2 * recordSize> buffer = { };
+
+        const Sample sample{ 1, 0 };
+        const auto unknownFlags = static_cast<uint8_t>(record::Checksummed | 0x80);
+        REQUIRE(record::encode(buffer, Sample::recordType, Sample::recordVersion, std::as_bytes(std::span<const Sample, 1>(&sample, 1)), unknownFlags) == recordSize);
+        REQUIRE(record::encode(std::span<std::byte>(buffer).subspan(recordSize), Sample{ 2, 0 }, record::Checksummed) == recordSize);
+
+        WHEN("the next valid record is searched for") {
+            const auto offset = record::find_next_valid(buffer);
+
+            THEN("the first one is passed over, even though it's intact") {
+                record::View view;
+                REQUIRE(record::decode(buffer, view));
+                REQUIRE(offset == recordSize);
+            }
+        }
+    }
+
+    GIVEN("a temporary file with some checksummed records written to it") {
+        File file = File::create_and_open_temporary();
+
+        for (uint64_t address = 1; address <= 3; ++address) {
+            REQUIRE(record::write(file, Sample{ address, 0 }, record::Checksummed) == record::get_record_size(sizeof(Sample), record::Checksummed));
+        }
+
+        const auto fileSize = static_cast<std::size_t>(file.seek(0, File::OffsetInterpretation::RelativeToCurrentPosition));
+        REQUIRE(fileSize == 3 * record::get_record_size(sizeof(Sample), record::Checksummed));
+
+        WHEN("it is read back intact") {
+            const auto mappedFile = MappedFile::map(file, 0, fileSize, File::Permissions::ReadOnly);
+            const record::Reader reader(mappedFile.get_bytes());
+
+            std::size_t count = 0;
+            for (const auto& view : reader) {
+                count += 1;
+                REQUIRE(view.get_as<Sample>()->address == count);
+                REQUIRE(view.get_header().flags == record::Checksummed);
+            }
+
+            THEN("every record is read") {
+                REQUIRE(count == 3);
+            }
+        }
+
+        WHEN("the middle record's payload is corrupted") {
+            const auto recordSize = record::get_record_size(sizeof(Sample), record::Checksummed);
+            REQUIRE(file.write_at(static_cast<off_t>(recordSize + sizeof(record::Header)), std::array<char, 1>{ 'x' }) == 1);
+
+            const auto mappedFile = MappedFile::map(file, 0, fileSize, File::Permissions::ReadOnly);
+            const record::Reader reader(mappedFile.get_bytes());
+
+            auto iterator = reader.begin();
+            std::size_t count = 0;
+            for (; iterator != reader.end(); ++iterator) {
+                count += 1;
+            }
+
+            THEN("reading stops at the corrupted record") {
+                REQUIRE(count == 1);
+                REQUIRE(iterator.get_unread().data() == mappedFile.get_bytes().data() + recordSize);
+            }
+
+            AND_WHEN("the next valid record is searched for") {
+                const auto unread = iterator.get_unread().subspan(record::alignment);
+                const auto offset = record::find_next_valid(unread);
+
+                THEN("the record after the corrupted one is found") {
+                    REQUIRE(unread.data() + offset == mappedFile.get_bytes().data() + 2 * recordSize);
+
+                    record::View view;
+                    REQUIRE(record::decode(unread.subspan(offset), view));
+                    REQUIRE(view.get_as<Sample>()->address == 3);
+                }
+            }
+        }
+    }
+}
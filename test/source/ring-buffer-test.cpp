@@ -0,0 +1,260 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/file.hpp>
+#include <signalsafe/ring-buffer.hpp>
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+using signalsafe::File;
+using signalsafe::MultiProducerRingBuffer;
+using signalsafe::SingleProducerRingBuffer;
+
+namespace {
+    template <typename RingBufferT>
+    void check_ring_buffer() {
+        GIVEN("an empty ring buffer") {
+            RingBufferT ringBuffer;
+
+            WHEN("pop is called") {
+                std::array<char, 8> target = { };
+                const auto bytesRead = ringBuffer.pop(target);
+
+                THEN("it returns 0") {
+                    REQUIRE(bytesRead == 0);
+                }
+            }
+
+            WHEN("two records are pushed") {
+                const char first[] = "first";
+                const char second[] = "the second";
+
+                REQUIRE(ringBuffer.push(first));
+                REQUIRE(ringBuffer.push(second));
+
+                THEN("they are popped in the order they were pushed") {
+                    std::array<char, 16> target = { };
+
+                    REQUIRE(ringBuffer.pop(target) == sizeof(first));
+                    REQUIRE(memcmp(target.data(), first, sizeof(first)) == 0);
+
+                    REQUIRE(ringBuffer.pop(target) == sizeof(second));
+                    REQUIRE(memcmp(target.data(), second, sizeof(second)) == 0);
+
+                    REQUIRE(ringBuffer.pop(target) == 0);
+                }
+
+                THEN("popping into a target that is too small truncates the record") {
+                    std::array<char, 3> target = { };
+
+                    REQUIRE(ringBuffer.pop(target) == target.size());
+                    REQUIRE(memcmp(target.data(), first, target.size()) == 0);
+
+                    AND_THEN("the next record is unaffected") {
+                        std::array<char, 16> nextTarget = { };
+                        REQUIRE(ringBuffer.pop(nextTarget) == sizeof(second));
+                    }
+                }
+
+                AND_WHEN("the ring buffer is drained into a file") {
+                    File file = File::create_and_open_temporary();
+                    const auto bytesWritten = ringBuffer.drain(file);
+
+                    THEN("every record is written back-to-back") {
+                        REQUIRE(bytesWritten == sizeof(first) + sizeof(second));
+
+                        std::array<char, sizeof(first) + sizeof(second)> readBack = { };
+                        REQUIRE(file.read_at(0, readBack) == readBack.size());
+                        REQUIRE(memcmp(readBack.data(), first, sizeof(first)) == 0);
+                        REQUIRE(memcmp(readBack.data() + sizeof(first), second, sizeof(second)) == 0);
+                    }
+
+                    THEN("the ring buffer is empty") {
+                        std::array<char, 16> target = { };
+                        REQUIRE(ringBuffer.pop(target) == 0);
+                    }
+                }
+            }
+
+            WHEN("records are pushed until it is full") {
+                const std::array<std::byte, 24> record = { };
+
+                // Each record takes 8 bytes of header and 24 bytes of payload.
+                REQUIRE(ringBuffer.push(record));
+                REQUIRE(ringBuffer.push(record));
+
+                THEN("another push fails") {
+                    REQUIRE(! ringBuffer.push(record));
+
+                    AND_THEN("it is counted as dropped") {
+                        REQUIRE(ringBuffer.get_dropped_count() == 1);
+                    }
+                }
+
+                AND_WHEN("one record is popped") {
+                    std::array<std::byte, 24> target;
+                    REQUIRE(ringBuffer.pop(target) == target.size());
+
+                    THEN("there is room for another") {
+                        REQUIRE(ringBuffer.push(record));
+                        REQUIRE(ringBuffer.get_dropped_count() == 0);
+                    }
+                }
+            }
+
+            WHEN("records that wrap around the end of the storage are pushed and popped") {
+                for (uint8_t i = 0; i < 20; ++i) {
+                    const std::array<std::byte, 13> record = {
+                        std::byte{i}, std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4},
+                        std::byte{5}, std::byte{6}, std::byte{7}, std::byte{8}, std::byte{9},
+                        std::byte{10}, std::byte{11}, std::byte{i}
+                    };
+
+                    REQUIRE(ringBuffer.push(record));
+
+                    std::array<std::byte, 13> target = { };
+                    REQUIRE(ringBuffer.pop(target) == target.size());
+                    REQUIRE(target == record);
+                }
+
+                THEN("nothing is dropped") {
+                    REQUIRE(ringBuffer.get_dropped_count() == 0);
+                }
+            }
+        }
+    }
+
+    template <typename RingBufferT>
+    void check_short_drain() {
+        GIVEN("a ring buffer holding records that won't all fit in a non-blocking pipe with PIPE_BUF bytes of room") {
+            std::array<int, 2> pipeFds = { -1, -1 };
+            REQUIRE(pipe(pipeFds.data()) == 0);
+
+            File readEnd = File::from_file_descriptor(pipeFds[0]);
+            File writeEnd = File::from_file_descriptor(pipeFds[1]);
+            REQUIRE(writeEnd.set_non_blocking(true));
+
+            const auto pipeCapacity = static_cast<std::size_t>(fcntl(pipeFds[1], F_GETPIPE_SZ));
+            std::vector<char> readBack(pipeCapacity);
+            REQUIRE(writeEnd.write(std::span<const char>(readBack).first(pipeCapacity - PIPE_BUF)) == pipeCapacity - PIPE_BUF);
+
+            // Each record is bigger than PIPE_BUF, so the pipe takes part of one rather than all or nothing.
+            std::vector<char> records(3 * (PIPE_BUF - PIPE_BUF / 4));
+            for (std::size_t i = 0; i < records.size(); ++i) {
+                records[i] = static_cast<char>(i % 251);
+            }
+
+            const auto recordSize = records.size() / 3;
+
+            RingBufferT ringBuffer;
+            for (std::size_t i = 0; i < 3; ++i) {
+                REQUIRE(ringBuffer.push(std::span<const char>(records).subspan(i * recordSize, recordSize)));
+            }
+
+            WHEN("it is drained") {
+                const auto bytesWritten = ringBuffer.drain(writeEnd);
+
+                THEN("only what fits is written") {
+                    REQUIRE(bytesWritten == PIPE_BUF);
+                }
+
+                AND_WHEN("the pipe is emptied and it is drained again") {
+                    REQUIRE(readEnd.read(readBack) == pipeCapacity);
+                    const auto moreBytesWritten = ringBuffer.drain(writeEnd);
+
+                    THEN("it carries on from where it left off, part way through a record") {
+                        REQUIRE(moreBytesWritten == records.size() - PIPE_BUF);
+                        REQUIRE(memcmp(readBack.data() + pipeCapacity - PIPE_BUF, records.data(), PIPE_BUF) == 0);
+
+                        REQUIRE(readEnd.read(std::span<char>(readBack).first(moreBytesWritten)) == moreBytesWritten);
+                        REQUIRE(memcmp(readBack.data(), records.data() + PIPE_BUF, moreBytesWritten) == 0);
+                    }
+
+                    THEN("the ring buffer is empty") {
+                        std::array<char, 16> target = { };
+                        REQUIRE(ringBuffer.pop(target) == 0);
+                    }
+                }
+
+                AND_WHEN("the rest of the partly written record is popped instead") {
+                    std::vector<char> target(recordSize);
+                    const auto bytesRead = ringBuffer.pop(target);
+
+                    THEN("only the part that wasn't written is popped") {
+                        REQUIRE(bytesRead == 2 * recordSize - PIPE_BUF);
+                        REQUIRE(memcmp(target.data(), records.data() + PIPE_BUF, bytesRead) == 0);
+                    }
+
+                    THEN("the next record is unaffected") {
+                        REQUIRE(ringBuffer.pop(target) == recordSize);
+                        REQUIRE(memcmp(target.data(), records.data() + 2 * recordSize, recordSize) == 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("signalsafe::SingleProducerRingBuffer") {
+    check_ring_buffer<SingleProducerRingBuffer<64>>();
+    check_short_drain<SingleProducerRingBuffer<16384>>();
+}
+
+SCENARIO("signalsafe::MultiProducerRingBuffer") {
+    check_ring_buffer<MultiProducerRingBuffer<64>>();
+    check_short_drain<MultiProducerRingBuffer<16384>>();
+
+    GIVEN("a ring buffer shared by several producer threads") {
+        static MultiProducerRingBuffer<4096> ringBuffer;
+
+        constexpr uint64_t threadCount = 4;
+        constexpr uint64_t recordsPerThread = 10000;
+
+        WHEN("every thread pushes records while the consumer pops them") {
+            std::vector<std::thread> producers;
+
+            for (uint64_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+                producers.emplace_back([threadIndex](){
+                    for (uint64_t i = 0; i < recordsPerThread; ++i) {
+                        const std::array<uint64_t, 2> record = { threadIndex, i };
+
+                        while(! ringBuffer.push(std::as_bytes(std::span(record))));
+                    }
+                });
+            }
+
+            std::array<uint64_t, threadCount> nextExpected = { };
+            uint64_t recordsPopped = 0;
+            bool inOrder = true;
+
+            while(recordsPopped != threadCount * recordsPerThread) {
+                std::array<uint64_t, 2> record;
+
+                if (ringBuffer.pop(std::as_writable_bytes(std::span(record))) == 0) {
+                    continue;
+                }
+
+                inOrder = inOrder && record[1] == nextExpected[record[0]];
+                nextExpected[record[0]] = record[1] + 1;
+                recordsPopped += 1;
+            }
+
+            for (auto& producer : producers) {
+                producer.join();
+            }
+
+            THEN("each thread's records arrive intact and in order") {
+                REQUIRE(inOrder);
+
+                for (const auto next : nextExpected) {
+                    REQUIRE(next == recordsPerThread);
+                }
+            }
+        }
+    }
+}
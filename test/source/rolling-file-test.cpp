@@ -0,0 +1,94 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/directory.hpp>
+#include <signalsafe/rolling-file.hpp>
+
+#include <array>
+#include <cstdlib>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using signalsafe::Directory;
+using signalsafe::RollingFile;
+
+namespace {
+    off_t get_file_size(const std::string& path) {
+        struct stat fileStatus;
+        return ::stat(path.c_str(), &fileStatus) == 0 ? fileStatus.st_size : -1;
+    }
+}
+
+SCENARIO("signalsafe::RollingFile") {
+    GIVEN("an empty directory") {
+        std::array<char, 32> directoryPath = { };
+        signalsafe::memory::copy_no_overlap(std::string_view("/tmp/signalsafe-rolling-XXXXXX"), directoryPath);
+        REQUIRE(::mkdtemp(directoryPath.data()) != nullptr);
+
+        const std::string basePath = std::string(directoryPath.data()) + "/trace";
+
+        AND_GIVEN("a rolling file in it that keeps 3 segments of up to 10 bytes") {
+            {
+                RollingFile<3> rollingFile(Directory::open_existing(directoryPath.data()), "trace", 10);
+
+                THEN("the segments are named after the file") {
+                    REQUIRE(rollingFile.get_segment_name(0) == "trace");
+                    REQUIRE(rollingFile.get_segment_name(1) == "trace.1");
+                    REQUIRE(rollingFile.get_segment_name(2) == "trace.2");
+                }
+
+                WHEN("writes that fit in one segment are made") {
+                    REQUIRE(rollingFile.write(std::array<char, 4>{ 'a', 'b', 'c', 'd' }) == 4);
+                    REQUIRE(rollingFile.write(std::array<char, 6>{ 'e', 'f', 'g', 'h', 'i', 'j' }) == 6);
+
+                    THEN("they all go to the current segment") {
+                        REQUIRE(rollingFile.get_segment_size() == 10);
+                        REQUIRE(get_file_size(basePath) == 10);
+                        REQUIRE(get_file_size(basePath + ".1") == -1);
+                    }
+                }
+
+                WHEN("more writes are made than fit in every segment") {
+                    for (char c = 'a'; c < 'f'; ++c) {
+                        REQUIRE(rollingFile.write(std::array<char, 8>{ c, c, c, c, c, c, c, c }) == 8);
+                    }
+
+                    THEN("each write that wouldn't fit starts a new segment") {
+                        REQUIRE(rollingFile.get_segment_size() == 8);
+                        REQUIRE(get_file_size(basePath) == 8);
+                        REQUIRE(get_file_size(basePath + ".1") == 8);
+                        REQUIRE(get_file_size(basePath + ".2") == 8);
+                    }
+
+                    THEN("no more than 3 segments are kept") {
+                        REQUIRE(get_file_size(basePath + ".3") == -1);
+                    }
+
+                    THEN("the oldest segments are the ones dropped") {
+                        std::array<char, 1> oldest = { };
+                        REQUIRE(Directory::open_existing(directoryPath.data())
+                                    .open_existing_at("trace.2", signalsafe::FileHandle::Permissions::ReadOnly)
+                                    .read(oldest) == 1);
+                        REQUIRE(oldest[0] == 'c');
+                    }
+                }
+
+                WHEN("a write bigger than a segment is made") {
+                    REQUIRE(rollingFile.write(std::array<char, 1>{ 'a' }) == 1);
+                    REQUIRE(rollingFile.write(std::array<char, 16>{ }) == 16);
+
+                    THEN("it gets a segment to itself") {
+                        REQUIRE(get_file_size(basePath) == 16);
+                        REQUIRE(get_file_size(basePath + ".1") == 1);
+                    }
+                }
+            }
+
+            ::unlink(basePath.c_str());
+            ::unlink((basePath + ".1").c_str());
+            ::unlink((basePath + ".2").c_str());
+        }
+
+        REQUIRE(::rmdir(directoryPath.data()) == 0);
+    }
+}
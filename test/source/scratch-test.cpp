@@ -0,0 +1,97 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/scratch.hpp>
+#include <signalsafe/string.hpp>
+
+#include <csignal>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+using signalsafe::memory::get_thread_scratch;
+using signalsafe::memory::thread_attach;
+using signalsafe::memory::thread_detach;
+
+namespace {
+    std::size_t g_handlerBytesWritten = 0;
+
+    void format_into_scratch(int) {
+        const auto scratch = get_thread_scratch();
+        const auto target = std::span<char>(reinterpret_cast<char*>(scratch.data()), scratch.size());
+
+        g_handlerBytesWritten = signalsafe::string::format("signal: %", target, int32_t{42});
+    }
+}
+
+SCENARIO("signalsafe::memory thread scratch") {
+    GIVEN("a thread that hasn't attached") {
+        std::size_t scratchSize = 1;
+
+        std::thread([&scratchSize](){
+            scratchSize = get_thread_scratch().size();
+        }).join();
+
+        THEN("it has no scratch region") {
+            REQUIRE(scratchSize == 0);
+        }
+    }
+
+    GIVEN("a thread that attaches a scratch region of less than a page") {
+        bool attached = false;
+        bool attachedAgain = true;
+        std::size_t scratchSize = 0;
+        bool writable = false;
+        std::size_t scratchSizeAfterDetach = 1;
+
+        std::thread([&](){
+            attached = thread_attach(100);
+            attachedAgain = thread_attach(100);
+
+            const auto scratch = get_thread_scratch();
+            scratchSize = scratch.size();
+
+            scratch.front() = std::byte{1};
+            scratch.back() = std::byte{2};
+            writable = scratch.front() == std::byte{1} && scratch.back() == std::byte{2};
+
+            thread_detach();
+            scratchSizeAfterDetach = get_thread_scratch().size();
+        }).join();
+
+        THEN("the attach succeeds, but only the first time") {
+            REQUIRE(attached);
+            REQUIRE(! attachedAgain);
+        }
+
+        THEN("the region is a whole page, and can be written to") {
+            REQUIRE(scratchSize == static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)));
+            REQUIRE(writable);
+        }
+
+        THEN("it's gone after detaching") {
+            REQUIRE(scratchSizeAfterDetach == 0);
+        }
+    }
+
+    GIVEN("a thread with a scratch region and a handler that formats into it") {
+        std::string formatted;
+
+        std::thread([&formatted](){
+            thread_attach(4096);
+
+            const auto previous = std::signal(SIGUSR1, format_into_scratch);
+            std::raise(SIGUSR1);
+            std::signal(SIGUSR1, previous);
+
+            const auto scratch = get_thread_scratch();
+            formatted = std::string(reinterpret_cast<const char*>(scratch.data()), g_handlerBytesWritten);
+
+            thread_detach();
+        }).join();
+
+        THEN("the handler's output is in the region") {
+            REQUIRE(formatted == std::string("signal: 42", sizeof("signal: 42")));
+        }
+    }
+}
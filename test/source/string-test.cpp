@@ -1,6 +1,11 @@
 #include "signalsafe-test.hpp"
 #include <signalsafe/string.hpp>
 
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+
 using signalsafe::string::format;
 
 SCENARIO("signalsafe::string") {
@@ -114,4 +119,78 @@ SCENARIO("signalsafe::string") {
             }
         }
     }
+
+    GIVEN("a format string with a single format specifier, and integers at the edges of each type's range") {
+        const char formatStr[] = "%";
+
+        const auto formatted = [&formatStr](const auto value) {
+            std::array<char, 32> targetStr = { };
+            const auto bytesWritten = format(formatStr, targetStr, value);
+            return std::string(targetStr.data(), bytesWritten - 1 /* for the terminator */);
+        };
+
+        THEN("8-bit integers are formatted as numbers, not characters") {
+            REQUIRE(formatted(int8_t{-128}) == "-128");
+            REQUIRE(formatted(int8_t{127}) == "127");
+            REQUIRE(formatted(uint8_t{255}) == "255");
+            REQUIRE(formatted(uint8_t{0}) == "0");
+        }
+
+        THEN("16-bit integers are formatted in full") {
+            REQUIRE(formatted(int16_t{-32768}) == "-32768");
+            REQUIRE(formatted(uint16_t{65535}) == "65535");
+        }
+
+        THEN("the most negative 32 and 64-bit integers are formatted in full") {
+            REQUIRE(formatted(std::numeric_limits<int32_t>::min()) == "-2147483648");
+            REQUIRE(formatted(std::numeric_limits<int64_t>::min()) == "-9223372036854775808");
+            REQUIRE(formatted(std::numeric_limits<long long>::min()) == "-9223372036854775808");
+        }
+
+        THEN("large 64-bit integers, beyond what a double holds exactly, are formatted in full") {
+            REQUIRE(formatted(std::numeric_limits<uint64_t>::max()) == "18446744073709551615");
+            REQUIRE(formatted(uint64_t{10000000000000000000ULL}) == "10000000000000000000");
+            REQUIRE(formatted(uint64_t{9999999999999999999ULL}) == "9999999999999999999");
+            REQUIRE(formatted(uint64_t{9007199254740993}) == "9007199254740993");
+            REQUIRE(formatted(std::size_t{18446744073709551614ULL}) == "18446744073709551614");
+            REQUIRE(formatted(std::numeric_limits<unsigned long long>::max()) == "18446744073709551615");
+        }
+
+        THEN("every power of 10, and one less, is formatted in full") {
+            uint64_t power = 1;
+            std::string expected = "1";
+
+            for (std::size_t digits = 1; digits <= 20; ++digits) {
+                REQUIRE(formatted(power) == expected);
+                REQUIRE(formatted(power - 1) == (digits == 1 ? std::string("0") : std::string(digits - 1, '9')));
+
+                if (digits < 20) {
+                    power *= 10;
+                    expected += '0';
+                }
+            }
+        }
+    }
+
+    GIVEN("a target that's too small for the whole number") {
+        std::array<char, 3> targetStr = { };
+
+        WHEN("a positive number is formatted into it") {
+            const auto bytesWritten = format(std::span<const char>("%", 1), targetStr, uint32_t{123456});
+
+            THEN("as many of the leading digits as fit are written") {
+                REQUIRE(bytesWritten == 3);
+                REQUIRE(std::string(targetStr.data(), 3) == "123");
+            }
+        }
+
+        WHEN("a negative number is formatted into it") {
+            const auto bytesWritten = format(std::span<const char>("%", 1), targetStr, int32_t{-123456});
+
+            THEN("the sign and as many of the leading digits as fit are written") {
+                REQUIRE(bytesWritten == 3);
+                REQUIRE(std::string(targetStr.data(), 3) == "-12");
+            }
+        }
+    }
 }
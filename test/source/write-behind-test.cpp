@@ -0,0 +1,55 @@
+#include "signalsafe-test.hpp"
+#include <signalsafe/file.hpp>
+#include <signalsafe/write-behind.hpp>
+
+#include <array>
+#include <cstddef>
+
+using signalsafe::File;
+using signalsafe::WriteBehind;
+
+SCENARIO("signalsafe::WriteBehind") {
+    GIVEN("a temporary file and a write-behind instance with 4096-byte chunks") {
+        File file = File::create_and_open_temporary();
+        WriteBehind writeBehind(file, 4096);
+
+        THEN("nothing has had write-back started") {
+            REQUIRE(writeBehind.get_written_back_up_to() == 0);
+        }
+
+        WHEN("less than a chunk is written") {
+            const std::array<std::byte, 1000> data = { };
+            REQUIRE(file.write(data) == data.size());
+
+            AND_WHEN("it is advanced") {
+                REQUIRE(writeBehind.advance(static_cast<off_t>(data.size())));
+
+                THEN("write-back isn't started for the incomplete chunk") {
+                    REQUIRE(writeBehind.get_written_back_up_to() == 0);
+                }
+            }
+        }
+
+        WHEN("more than two chunks are written") {
+            const std::array<std::byte, 10000> data = { };
+            REQUIRE(file.write(data) == data.size());
+
+            AND_WHEN("it is advanced") {
+                REQUIRE(writeBehind.advance(static_cast<off_t>(data.size())));
+
+                THEN("write-back is started for the whole chunks only") {
+                    REQUIRE(writeBehind.get_written_back_up_to() == 8192);
+                }
+
+                AND_WHEN("another chunk is completed and it is advanced again") {
+                    REQUIRE(file.write(data) == data.size());
+                    REQUIRE(writeBehind.advance(static_cast<off_t>(data.size() * 2)));
+
+                    THEN("write-back carries on from where it left off") {
+                        REQUIRE(writeBehind.get_written_back_up_to() == 16384);
+                    }
+                }
+            }
+        }
+    }
+}